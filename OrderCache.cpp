@@ -1,57 +1,264 @@
 #include "OrderCache.h"
 #include <algorithm>
+#include <cassert>
 #include <shared_mutex>
+#include <string_view>
+
+namespace {
+
+// Bytes a string holds on the heap, zero when it fits the small string buffer
+std::size_t stringHeapBytes(const std::string& str) {
+    const char* object = reinterpret_cast<const char*>(&str);
+    std::less<const char*> before;
+    bool isInline = !before(str.data(), object) && before(str.data(), object + sizeof(str));
+    return isInline ? 0 : str.capacity() + 1;
+}
+
+// Estimated size of a node in a std::map or std::multimap: the value plus
+// parent, left and right links and the color
+template <typename Map>
+std::size_t treeNodeBytes() {
+    return sizeof(typename Map::value_type) + 4 * sizeof(void*);
+}
+
+// Estimated size of a std::unordered_map or std::unordered_set: the bucket
+// array plus, per element, the value, a next link and the cached hash
+template <typename HashTable>
+std::size_t hashTableBytes(const HashTable& table) {
+    return table.bucket_count() * sizeof(void*) + table.size() * (sizeof(typename HashTable::value_type) + 2 * sizeof(void*));
+}
+
+}  // namespace
+
+// Sum the heap storage of every string in this order
+std::size_t Order::stringHeapBytes() const {
+    return ::stringHeapBytes(m_orderId) + ::stringHeapBytes(m_securityId) + ::stringHeapBytes(m_side) +
+           ::stringHeapBytes(m_user) + ::stringHeapBytes(m_company) + ::stringHeapBytes(m_session);
+}
 
 // Add an order to the cache
 void OrderCache::addOrder(Order order) {
-    // Lock only during modifications
-    {
-        std::unique_lock lockSecId(secIdMutex);  // Lock ordersBySecId for writing
-        auto it = ordersBySecId.emplace(order.securityId(), order);
-        
-        std::unique_lock lockOrderId(orderIdMutex);  // Lock ordersById for writing
-        ordersById[order.orderId()] = it;
-        
-        std::unique_lock lockUser(userMutex);  // Lock ordersByUser for writing
-        ordersByUser[order.user()].push_back(it);
+    // Lock in the fixed order secIdMutex -> orderIdMutex -> userMutex
+    std::unique_lock lockSecId(secIdMutex);      // Lock ordersBySecId for writing
+    std::unique_lock lockOrderId(orderIdMutex);  // Lock ordersById for writing
+    std::unique_lock lockUser(userMutex);        // Lock ordersByUser for writing
+
+    auto it = ordersBySecId.emplace(order.securityId(), order);
+    addToSecurityIndex(it);
+    ordersById.insertOrAssign(order.orderId(), it);
+    addOrderToUserMap(it);
+
+    std::string session = order.session();
+    if (!session.empty()) {
+        ordersBySession[session].insert(it);
     }
 }
 
 // Cancel a specific order by its orderId
 void OrderCache::cancelOrder(const std::string& orderId) {
+    // Lock in the fixed order secIdMutex -> orderIdMutex -> userMutex
+    std::unique_lock lockSecId(secIdMutex);      // Lock ordersBySecId for writing
     std::unique_lock lockOrderId(orderIdMutex);  // Lock ordersById for writing
-    auto it = ordersById.find(orderId);
-    if (it != ordersById.end()) {
-        // Lock ordersBySecId for removing
-        {
-            std::unique_lock lockSecId(secIdMutex);
-            ordersBySecId.erase(it->second);
+    std::unique_lock lockUser(userMutex);        // Lock ordersByUser for writing
+
+    if (OrderIterator* found = ordersById.find(orderId)) {
+        removeOrder(found);
+    }
+}
+
+// Cancel a batch of orders by orderId under a single lock acquisition
+void OrderCache::cancelOrders(const std::vector<std::string>& orderIds) {
+    // Hash every id up front so the index slots can be prefetched ahead of use
+    std::vector<std::uint64_t> hashes(orderIds.size());
+    for (std::size_t i = 0; i < orderIds.size(); i++) {
+        hashes[i] = OrderIdIndex<OrderIterator>::hashId(orderIds[i]);
+    }
+
+    // Lock in the fixed order secIdMutex -> orderIdMutex -> userMutex
+    std::unique_lock lockSecId(secIdMutex);      // Lock ordersBySecId for writing
+    std::unique_lock lockOrderId(orderIdMutex);  // Lock ordersById for writing
+    std::unique_lock lockUser(userMutex);        // Lock ordersByUser for writing
+
+    constexpr std::size_t PREFETCH_DISTANCE = 8;
+    for (std::size_t i = 0; i < orderIds.size() && i < PREFETCH_DISTANCE; i++) {
+        ordersById.prefetch(hashes[i]);
+    }
+    for (std::size_t i = 0; i < orderIds.size(); i++) {
+        if (i + PREFETCH_DISTANCE < orderIds.size()) {
+            ordersById.prefetch(hashes[i + PREFETCH_DISTANCE]);
         }
+        if (OrderIterator* found = ordersById.find(orderIds[i], hashes[i])) {
+            removeOrder(found);
+        }
+    }
+}
+
+// Amend the qty of a specific order in place
+bool OrderCache::amendOrderQty(const std::string& orderId, unsigned int newQty) {
+    // Lock in the fixed order secIdMutex -> orderIdMutex -> userMutex
+    std::unique_lock lockSecId(secIdMutex);      // Lock ordersBySecId for writing
+    std::unique_lock lockOrderId(orderIdMutex);  // Lock ordersById for writing
+    std::unique_lock lockUser(userMutex);        // Lock ordersByUser for writing
+
+    OrderIterator* found = ordersById.find(orderId);
+    if (!found) {
+        return false;
+    }
+    if (newQty == 0) {
+        removeOrder(found);
+        return true;
+    }
+    OrderIterator orderIt = *found;
+    if (newQty == orderIt->second.qty()) {
+        return true;
+    }
+
+    // Only the qty levels and company totals depend on qty
+    removeFromSecurityIndex(orderIt);
+    orderIt->second.setQty(newQty);
+    addToSecurityIndex(orderIt);
+    return true;
+}
 
-        // Lock ordersByUser for removing
-        {
-            std::unique_lock lockUser(userMutex);
-            removeOrderFromUserMap(it->second->second.user(), it->second);
+// Replace a specific order, keeping its place in every index whose key is unchanged
+bool OrderCache::replaceOrder(const std::string& orderId, Order order) {
+    // Lock in the fixed order secIdMutex -> orderIdMutex -> userMutex
+    std::unique_lock lockSecId(secIdMutex);      // Lock ordersBySecId for writing
+    std::unique_lock lockOrderId(orderIdMutex);  // Lock ordersById for writing
+    std::unique_lock lockUser(userMutex);        // Lock ordersByUser for writing
+
+    OrderIterator* found = ordersById.find(orderId);
+    if (!found) {
+        return false;
+    }
+    if (order.qty() == 0) {
+        removeOrder(found);  // same as amending to 0
+        return true;
+    }
+    OrderIterator orderIt = *found;
+    std::string newOrderId = order.orderId();
+    bool idChanged = newOrderId != orderId;
+    if (idChanged && ordersById.contains(newOrderId)) {
+        return false;  // the new id already belongs to another order
+    }
+
+    std::string newUser = order.user();
+    std::string newSession = order.session();
+    if (newSession.empty()) {
+        // Gateways need not repeat the tag, and the order must stay covered by cancel-on-disconnect
+        newSession = orderIt->second.session();
+        order.setSession(newSession);
+    }
+    bool secIdChanged = order.securityId() != orderIt->first;
+    // Moving to another security re-links the node, so every index entry is rebuilt
+    bool userChanged = secIdChanged || newUser != orderIt->second.user();
+    bool sessionChanged = secIdChanged || newSession != orderIt->second.session();
+
+    removeFromSecurityIndex(orderIt);
+    if (userChanged) {
+        removeOrderFromUserMap(orderIt->second.user(), orderIt);
+    }
+    if (sessionChanged) {
+        removeOrderFromSessionMap(orderIt);
+    }
+
+    if (secIdChanged) {
+        // Re-link the existing node under the new security instead of reallocating it
+        auto node = ordersBySecId.extract(orderIt);
+        node.key() = order.securityId();
+        node.mapped() = std::move(order);
+        orderIt = ordersBySecId.insert(std::move(node));
+    } else {
+        orderIt->second = std::move(order);
+    }
+
+    addToSecurityIndex(orderIt);
+    if (idChanged) {
+        ordersById.erase(orderId);
+    }
+    ordersById.insertOrAssign(newOrderId, orderIt);
+    if (userChanged) {
+        addOrderToUserMap(orderIt);
+    }
+    if (sessionChanged && !newSession.empty()) {
+        ordersBySession[newSession].insert(orderIt);
+    }
+    return true;
+}
+
+// Pre-size the hashed indexes for the expected population
+void OrderCache::reserve(std::size_t expectedOrders, std::size_t expectedSecurities, std::size_t expectedUsers,
+                         std::size_t expectedSessions) {
+    // Lock in the fixed order secIdMutex -> orderIdMutex -> userMutex
+    std::unique_lock lockSecId(secIdMutex);      // Lock securityIndexes for writing
+    std::unique_lock lockOrderId(orderIdMutex);  // Lock ordersById for writing
+    std::unique_lock lockUser(userMutex);        // Lock ordersByUser and ordersBySession for writing
+
+    ordersById.reserve(expectedOrders);
+    securityIndexes.reserve(expectedSecurities);
+    ordersByUser.reserve(expectedUsers);
+    ordersBySession.reserve(expectedSessions);
+}
+
+// Estimate the memory held by each index and by string storage
+OrderCacheMemoryUsage OrderCache::memoryUsage() const {
+    // Lock in the fixed order secIdMutex -> orderIdMutex -> userMutex
+    std::shared_lock lockSecId(secIdMutex);      // Lock ordersBySecId and securityIndexes for reading
+    std::shared_lock lockOrderId(orderIdMutex);  // Lock ordersById for reading
+    std::shared_lock lockUser(userMutex);        // Lock ordersByUser and ordersBySession for reading
+
+    using SecIdMap = std::multimap<std::string, Order>;
+    using QtyLevelMap = decltype(SecurityIndex::ordersByQty);
+    OrderCacheMemoryUsage usage;
+
+    usage.ordersBySecId = ordersBySecId.size() * treeNodeBytes<SecIdMap>();
+    for (const auto& [securityId, order] : ordersBySecId) {
+        usage.strings += stringHeapBytes(securityId) + order.stringHeapBytes();
+    }
+
+    usage.ordersById = ordersById.memoryUsage();
+
+    usage.ordersByUser = hashTableBytes(ordersByUser);
+    for (const auto& [user, userOrders] : ordersByUser) {
+        usage.ordersByUser += userOrders.capacity() * sizeof(OrderIterator);
+        usage.strings += stringHeapBytes(user);
+    }
+
+    usage.securityIndexes = hashTableBytes(securityIndexes);
+    for (const auto& [securityId, index] : securityIndexes) {
+        usage.strings += stringHeapBytes(securityId);
+        usage.securityIndexes += index.ordersByQty.size() * treeNodeBytes<QtyLevelMap>();
+        for (const auto& level : index.ordersByQty) {
+            usage.securityIndexes += level.second.capacity() * sizeof(OrderIterator);
         }
-        ordersById.erase(it);
+        usage.securityIndexes += hashTableBytes(index.openQtyByCompany);
+        for (const auto& company : index.openQtyByCompany) {
+            usage.strings += stringHeapBytes(company.first);
+        }
+    }
+
+    usage.ordersBySession = hashTableBytes(ordersBySession);
+    for (const auto& [session, orderIts] : ordersBySession) {
+        usage.ordersBySession += hashTableBytes(orderIts);
+        usage.strings += stringHeapBytes(session);
     }
+    return usage;
 }
 
 // Cancel all orders for a specific user
 void OrderCache::cancelOrdersForUser(const std::string& user) {
-    std::unique_lock lockUser(userMutex);  // Lock ordersByUser for writing
+    // Lock in the fixed order secIdMutex -> orderIdMutex -> userMutex
+    std::unique_lock lockSecId(secIdMutex);      // Lock ordersBySecId for writing
+    std::unique_lock lockOrderId(orderIdMutex);  // Lock ordersById for writing
+    std::unique_lock lockUser(userMutex);        // Lock ordersByUser for writing
+
     auto it = ordersByUser.find(user);
     if (it != ordersByUser.end()) {
         for (auto orderIt : it->second) {
-            // Lock ordersBySecId and ordersById individually
-            {
-                std::unique_lock lockSecId(secIdMutex);
-                ordersBySecId.erase(orderIt);
-            }
-            {
-                std::unique_lock lockOrderId(orderIdMutex);
-                ordersById.erase(orderIt->second.orderId());
-            }
+            ordersById.erase(orderIt->second.orderId());
+            removeOrderFromSessionMap(orderIt);
+            removeFromSecurityIndex(orderIt);
+            ordersBySecId.erase(orderIt);
         }
         ordersByUser.erase(it);
     }
@@ -59,18 +266,45 @@ void OrderCache::cancelOrdersForUser(const std::string& user) {
 
 // Cancel orders for a specific security with a minimum quantity
 void OrderCache::cancelOrdersForSecIdWithMinimumQty(const std::string& securityId, unsigned int minQty) {
-    std::unique_lock lockSecId(secIdMutex);  // Lock ordersBySecId for writing
+    // Lock in the fixed order secIdMutex -> orderIdMutex -> userMutex
+    std::unique_lock lockSecId(secIdMutex);      // Lock ordersBySecId for writing
+    std::unique_lock lockOrderId(orderIdMutex);  // Lock ordersById for writing
+    std::unique_lock lockUser(userMutex);        // Lock ordersByUser for writing
+
+    removeOrdersForSecIdWithMinimumQty(securityId, minQty);
+}
+
+// Cancel orders for several securities, each with its own minimum quantity
+void OrderCache::cancelOrdersForSecIdsWithMinimumQty(const std::vector<std::pair<std::string, unsigned int>>& requests) {
+    // Cancelling qty >= a and then qty >= b removes the same orders as qty >= min(a, b),
+    // so each security is swept once
+    std::unordered_map<std::string_view, unsigned int> minQtyBySecId;
+    for (const auto& [securityId, minQty] : requests) {
+        auto [it, inserted] = minQtyBySecId.emplace(securityId, minQty);
+        if (!inserted) {
+            it->second = std::min(it->second, minQty);
+        }
+    }
+
+    // Lock in the fixed order secIdMutex -> orderIdMutex -> userMutex
+    std::unique_lock lockSecId(secIdMutex);      // Lock ordersBySecId for writing
+    std::unique_lock lockOrderId(orderIdMutex);  // Lock ordersById for writing
+    std::unique_lock lockUser(userMutex);        // Lock ordersByUser for writing
+
+    for (const auto& [securityId, minQty] : minQtyBySecId) {
+        removeOrdersForSecIdWithMinimumQty(std::string(securityId), minQty);
+    }
+}
+
+// Helper method to remove orders for a security with qty >= minQty
+void OrderCache::removeOrdersForSecIdWithMinimumQty(const std::string& securityId, unsigned int minQty) {
     auto range = ordersBySecId.equal_range(securityId);
     for (auto it = range.first; it != range.second; ) {
         if (it->second.qty() >= minQty) {
-            {
-                std::unique_lock lockUser(userMutex);
-                removeOrderFromUserMap(it->second.user(), it);
-            }
-            {
-                std::unique_lock lockOrderId(orderIdMutex);
-                ordersById.erase(it->second.orderId());
-            }
+            removeOrderFromUserMap(it->second.user(), it);
+            ordersById.erase(it->second.orderId());
+            removeOrderFromSessionMap(it);
+            removeFromSecurityIndex(it);
             it = ordersBySecId.erase(it);  // Move to the next iterator
         } else {
             ++it;
@@ -78,42 +312,87 @@ void OrderCache::cancelOrdersForSecIdWithMinimumQty(const std::string& securityI
     }
 }
 
+// Cancel all orders for a specific session
+void OrderCache::cancelOrdersForSession(const std::string& session) {
+    // Lock in the fixed order secIdMutex -> orderIdMutex -> userMutex
+    std::unique_lock lockSecId(secIdMutex);      // Lock ordersBySecId for writing
+    std::unique_lock lockOrderId(orderIdMutex);  // Lock ordersById for writing
+    std::unique_lock lockUser(userMutex);        // Lock ordersByUser and ordersBySession for writing
+
+    auto it = ordersBySession.find(session);
+    if (it == ordersBySession.end()) {
+        return;
+    }
+    // Detach the session's set first; every other index drops each order by
+    // its recorded position, so the purge costs O(1) per session order
+    OrderIteratorSet orderIts = std::move(it->second);
+    ordersBySession.erase(it);
+
+    for (auto orderIt : orderIts) {
+        ordersById.erase(orderIt->second.orderId());
+        removeOrderFromUserMap(orderIt->second.user(), orderIt);
+        removeFromSecurityIndex(orderIt);
+        ordersBySecId.erase(orderIt);
+    }
+}
+
 // Get the total matching size for a security
 unsigned int OrderCache::getMatchingSizeForSecurity(const std::string& securityId) {
     std::shared_lock lockSecId(secIdMutex);  // Lock ordersBySecId for reading
+    return computeMatchingSize(securityId);
+}
+
+// Get the total matching size for several securities under a single lock acquisition
+void OrderCache::getMatchingSizesForSecurities(const std::vector<std::string>& securityIds, std::vector<unsigned int>& out) const {
+    out.resize(securityIds.size());
+    std::unordered_map<std::string_view, unsigned int> sizeBySecId;  // Each security is matched once per call
+
+    std::shared_lock lockSecId(secIdMutex);  // Lock ordersBySecId for reading
+    for (std::size_t i = 0; i < securityIds.size(); i++) {
+        auto [it, inserted] = sizeBySecId.emplace(securityIds[i], 0);
+        if (inserted) {
+            it->second = computeMatchingSize(securityIds[i]);
+        }
+        out[i] = it->second;
+    }
+}
+
+// Helper method to compute the total matching size for a security
+unsigned int OrderCache::computeMatchingSize(const std::string& securityId) const {
     unsigned int totalMatchingSize = 0;
     auto range = ordersBySecId.equal_range(securityId);
 
-    std::vector<std::multimap<std::string, Order>::iterator> buyOrders;
-    std::vector<std::multimap<std::string, Order>::iterator> sellOrders;
+    // Match on local remaining qtys so the cached orders are left untouched
+    std::vector<std::pair<const Order*, unsigned int>> buyOrders;
+    std::vector<std::pair<const Order*, unsigned int>> sellOrders;
 
     for (auto it = range.first; it != range.second; ++it) {
         if (it->second.side() == "Buy") {
-            buyOrders.push_back(it);
+            buyOrders.emplace_back(&it->second, it->second.qty());
         } else if (it->second.side() == "Sell") {
-            sellOrders.push_back(it);
+            sellOrders.emplace_back(&it->second, it->second.qty());
         }
     }
 
     for (auto buyIt = buyOrders.begin(); buyIt != buyOrders.end(); ++buyIt) {
         for (auto sellIt = sellOrders.begin(); sellIt != sellOrders.end(); ) {
-            Order& buyOrder = (*buyIt)->second;
-            Order& sellOrder = (*sellIt)->second;
+            auto& buyOrder = *buyIt;
+            auto& sellOrder = *sellIt;
 
-            if (buyOrder.company() != sellOrder.company()) {
-                unsigned int matchQty = std::min(buyOrder.qty(), sellOrder.qty());
+            if (buyOrder.first->company() != sellOrder.first->company()) {
+                unsigned int matchQty = std::min(buyOrder.second, sellOrder.second);
                 totalMatchingSize += matchQty;
 
-                buyOrder.reduceQty(matchQty);
-                sellOrder.reduceQty(matchQty);
+                buyOrder.second -= matchQty;
+                sellOrder.second -= matchQty;
 
-                if (sellOrder.qty() == 0) {
+                if (sellOrder.second == 0) {
                     sellIt = sellOrders.erase(sellIt);
                 } else {
                     ++sellIt;
                 }
 
-                if (buyOrder.qty() == 0) {
+                if (buyOrder.second == 0) {
                     break;
                 }
             } else {
@@ -135,11 +414,155 @@ std::vector<Order> OrderCache::getAllOrders() const {
     return allOrders;
 }
 
+// Helper method to remove the order in this ordersById slot from every index and from ordersBySecId
+void OrderCache::removeOrder(OrderIterator* found) {
+    OrderIterator orderIt = *found;
+    ordersById.erase(found);  // erases the slot already found, without hashing the id again
+    removeOrderFromUserMap(orderIt->second.user(), orderIt);
+    removeOrderFromSessionMap(orderIt);
+    removeFromSecurityIndex(orderIt);
+    ordersBySecId.erase(orderIt);
+}
+
 // Helper method to remove an order from the user map
 void OrderCache::removeOrderFromUserMap(const std::string& user, std::multimap<std::string, Order>::iterator orderIt) {
-    auto& userOrders = ordersByUser[user];
-    userOrders.erase(std::remove(userOrders.begin(), userOrders.end(), orderIt), userOrders.end());
+    auto userIt = ordersByUser.find(user);
+    assert(userIt != ordersByUser.end() && "resident order has no user list");
+    auto& userOrders = userIt->second;
+    std::size_t pos = orderIt->second.m_userPos.value;
+    assert(pos < userOrders.size() && userOrders[pos] == orderIt && "stale position in user list");
+
+    // Move the user's last order into the freed position
+    userOrders[pos] = userOrders.back();
+    userOrders[pos]->second.m_userPos.value = pos;
+    userOrders.pop_back();
     if (userOrders.empty()) {
-        ordersByUser.erase(user);
+        ordersByUser.erase(userIt);
+    }
+}
+
+// Helper method to add an order to the user map
+void OrderCache::addOrderToUserMap(OrderIterator orderIt) {
+    auto& userOrders = ordersByUser[orderIt->second.user()];
+    orderIt->second.m_userPos.value = userOrders.size();
+    userOrders.push_back(orderIt);
+}
+
+// Get all orders for a specific user
+void OrderCache::getOrdersForUser(const std::string& user, std::vector<Order>& out) const {
+    std::shared_lock lockSecId(secIdMutex);  // Lock ordersBySecId for reading
+    std::shared_lock lockUser(userMutex);    // Lock ordersByUser for reading
+    out.clear();
+    auto it = ordersByUser.find(user);
+    if (it != ordersByUser.end()) {
+        out.reserve(it->second.size());
+        for (auto orderIt : it->second) {
+            out.push_back(orderIt->second);
+        }
+    }
+}
+
+// Get all orders for a specific security
+void OrderCache::getOrdersForSecurity(const std::string& securityId, std::vector<Order>& out) const {
+    std::shared_lock lockSecId(secIdMutex);  // Lock ordersBySecId for reading
+    out.clear();
+    auto range = ordersBySecId.equal_range(securityId);
+    for (auto it = range.first; it != range.second; ++it) {
+        out.push_back(it->second);
+    }
+}
+
+// Get the n largest orders for a specific security
+void OrderCache::topOrdersByQty(const std::string& securityId, std::size_t n, std::vector<Order>& out) const {
+    std::shared_lock lockSecId(secIdMutex);  // Lock securityIndexes for reading
+    out.clear();
+    auto it = securityIndexes.find(securityId);
+    if (it != securityIndexes.end()) {
+        const auto& index = it->second;
+        out.reserve(std::min(n, index.orderCount));
+        for (auto qtyIt = index.ordersByQty.begin(); qtyIt != index.ordersByQty.end() && out.size() < n; ++qtyIt) {
+            for (auto orderIt : qtyIt->second) {
+                if (out.size() == n) {
+                    break;
+                }
+                out.push_back(orderIt->second);
+            }
+        }
+    }
+}
+
+// Get the total open qty per company for a specific security
+void OrderCache::openQtyByCompany(const std::string& securityId, std::vector<std::pair<std::string, unsigned int>>& out) const {
+    std::shared_lock lockSecId(secIdMutex);  // Lock securityIndexes for reading
+    out.clear();
+    auto it = securityIndexes.find(securityId);
+    if (it != securityIndexes.end()) {
+        out.assign(it->second.openQtyByCompany.begin(), it->second.openQtyByCompany.end());
+    }
+}
+
+// Helper method to add an order to the per-security indexes
+void OrderCache::addToSecurityIndex(OrderIterator orderIt) {
+    Order& order = orderIt->second;
+    auto& index = securityIndexes[orderIt->first];
+    auto& qtyOrders = index.ordersByQty[order.qty()];
+    order.m_qtyLevelPos.value = qtyOrders.size();
+    qtyOrders.push_back(orderIt);
+    ++index.orderCount;
+    index.openQtyByCompany[order.company()] += order.qty();
+}
+
+// Helper method to remove an order from the per-security indexes
+void OrderCache::removeFromSecurityIndex(OrderIterator orderIt) {
+    const Order& order = orderIt->second;
+    auto indexIt = securityIndexes.find(orderIt->first);
+    assert(indexIt != securityIndexes.end() && "resident order has no security index");
+    auto& index = indexIt->second;
+
+    auto qtyIt = index.ordersByQty.find(order.qty());
+    assert(qtyIt != index.ordersByQty.end() && "resident order has no qty level");
+    auto& qtyOrders = qtyIt->second;
+    std::size_t pos = order.m_qtyLevelPos.value;
+    assert(pos < qtyOrders.size() && qtyOrders[pos] == orderIt && "stale position in qty level");
+
+    // Move the level's last order into the freed position
+    qtyOrders[pos] = qtyOrders.back();
+    qtyOrders[pos]->second.m_qtyLevelPos.value = pos;
+    qtyOrders.pop_back();
+    --index.orderCount;
+    if (qtyOrders.empty()) {
+        index.ordersByQty.erase(qtyIt);
+    }
+
+    reduceOpenQty(index, order);
+
+    if (index.orderCount == 0) {
+        securityIndexes.erase(indexIt);
+    }
+}
+
+// Helper method to take an order's qty out of its company's open qty
+void OrderCache::reduceOpenQty(SecurityIndex& index, const Order& order) {
+    auto companyIt = index.openQtyByCompany.find(order.company());
+    if (companyIt != index.openQtyByCompany.end()) {
+        companyIt->second -= order.qty();
+        if (companyIt->second == 0) {
+            index.openQtyByCompany.erase(companyIt);
+        }
+    }
+}
+
+// Helper method to remove an order from the session map
+void OrderCache::removeOrderFromSessionMap(OrderIterator orderIt) {
+    std::string session = orderIt->second.session();
+    if (session.empty()) {
+        return;
+    }
+    auto it = ordersBySession.find(session);
+    if (it != ordersBySession.end()) {
+        it->second.erase(orderIt);
+        if (it->second.empty()) {
+            ordersBySession.erase(it);
+        }
     }
 }
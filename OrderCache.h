@@ -2,9 +2,26 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <map>
+#include <utility>
+#include <functional>
 #include <mutex>
 #include <shared_mutex>
+#include "OrderIdIndex.h"
+
+// Position of a resident order in one of OrderCache's index lists. It belongs
+// to the cache's own copy of the order, so copying or assigning an Order never
+// carries it along: copies start at 0 and assignment keeps the target's value.
+class OrderIndexPos
+{
+public:
+    OrderIndexPos() = default;
+    OrderIndexPos(const OrderIndexPos&) {}
+    OrderIndexPos& operator=(const OrderIndexPos&) { return *this; }
+
+    std::size_t value = 0;
+};
 
 class Order
 {
@@ -34,6 +51,14 @@ class Order
   std::string company() const    { return m_company; }
   unsigned int qty() const       { return m_qty; }
   void reduceQty(unsigned int reduceBy) { m_qty -= reduceBy; }
+  void setQty(unsigned int qty)  { m_qty = qty; }
+
+  // optional session/owner tag, empty when the order is not tied to a session
+  std::string session() const    { return m_session; }
+  void setSession(const std::string& session) { m_session = session; }
+
+  // bytes held on the heap by this order's strings, for memory accounting
+  std::size_t stringHeapBytes() const;
 
  private:
 
@@ -45,6 +70,12 @@ class Order
   unsigned int m_qty;        // qty for this order
   std::string m_user;        // user name who owns this order
   std::string m_company;     // company for user
+  std::string m_session;     // gateway session that entered this order, may be empty
+
+  // bookkeeping for OrderCache's indexes, not part of the order data
+  friend class OrderCache;
+  OrderIndexPos m_qtyLevelPos;  // position in its qty level in OrderCache::SecurityIndex
+  OrderIndexPos m_userPos;      // position in its user's list in OrderCache::ordersByUser
 
 };
 
@@ -78,6 +109,23 @@ class OrderCacheInterface
 
 };
 
+// Estimated bytes held by each part of an OrderCache. Container figures cover
+// nodes, buckets and slots; heap storage of strings too long for the small
+// string buffer is counted once, under strings. Ids kept out of line by
+// ordersById count towards ordersById.
+struct OrderCacheMemoryUsage {
+    std::size_t ordersBySecId = 0;
+    std::size_t ordersById = 0;
+    std::size_t ordersByUser = 0;
+    std::size_t securityIndexes = 0;
+    std::size_t ordersBySession = 0;
+    std::size_t strings = 0;
+
+    std::size_t total() const {
+        return ordersBySecId + ordersById + ordersByUser + securityIndexes + ordersBySession + strings;
+    }
+};
+
 class OrderCache : public OrderCacheInterface
 {
 public:
@@ -88,17 +136,105 @@ public:
     unsigned int getMatchingSizeForSecurity(const std::string& securityId) override;
     std::vector<Order> getAllOrders() const override;
 
+    // Query methods served from the maintained indexes. Each clears and fills
+    // the caller-supplied buffer so its capacity can be reused across calls.
+
+    // all orders for this user
+    void getOrdersForUser(const std::string& user, std::vector<Order>& out) const;
+
+    // all orders for this security
+    void getOrdersForSecurity(const std::string& securityId, std::vector<Order>& out) const;
+
+    // the n largest orders for this security, largest qty first
+    void topOrdersByQty(const std::string& securityId, std::size_t n, std::vector<Order>& out) const;
+
+    // total open qty per company for this security
+    void openQtyByCompany(const std::string& securityId, std::vector<std::pair<std::string, unsigned int>>& out) const;
+
+    // remove the orders with these unique order ids, in one critical section
+    void cancelOrders(const std::vector<std::string>& orderIds);
+
+    // total matching qty for each of these securities, in one critical section;
+    // out[i] is the result for securityIds[i]
+    void getMatchingSizesForSecurities(const std::vector<std::string>& securityIds, std::vector<unsigned int>& out) const;
+
+    // apply each (securityId, minQty) cancel from cancelOrdersForSecIdWithMinimumQty,
+    // in one critical section
+    void cancelOrdersForSecIdsWithMinimumQty(const std::vector<std::pair<std::string, unsigned int>>& requests);
+
+    // remove all orders in the cache tagged with this session, in one critical section
+    void cancelOrdersForSession(const std::string& session);
+
+    // set the qty of the order with this id in place, a qty of 0 cancels it;
+    // returns false if there is no such order
+    bool amendOrderQty(const std::string& orderId, unsigned int newQty);
+
+    // replace the order with this id by order, which may carry a new id; an
+    // order with no session tag keeps the session of the order it replaces, and
+    // a qty of 0 cancels the order as amendOrderQty does; returns false if
+    // there is no such order or the new id is already in use
+    bool replaceOrder(const std::string& orderId, Order order);
+
+    // size the hashed indexes up front so that this many orders, securities,
+    // users and sessions can be held without a rehash; ordersBySecId nodes, the
+    // per-user and per-qty-level order lists and each session's order set are
+    // still allocated as orders arrive
+    void reserve(std::size_t expectedOrders, std::size_t expectedSecurities, std::size_t expectedUsers,
+                 std::size_t expectedSessions = 0);
+
+    // estimated memory held by each index and by string storage
+    OrderCacheMemoryUsage memoryUsage() const;
+
 private:
-    // Mutexes for each shared resource
+    using OrderIterator = std::multimap<std::string, Order>::iterator;
+
+    // Per-security indexes, guarded by secIdMutex together with ordersBySecId
+    struct SecurityIndex {
+        // Maps qty -> orders at that qty, largest first. Each order records its
+        // position in its level, so it can be swap-removed without a search.
+        std::map<unsigned int, std::vector<OrderIterator>, std::greater<unsigned int>> ordersByQty;
+        std::size_t orderCount = 0;  // Number of orders held across all qty levels
+        std::unordered_map<std::string, unsigned int> openQtyByCompany;  // Maps company -> total open qty
+    };
+
+    // Hashes an order by the address of its node in ordersBySecId
+    struct OrderIteratorHash {
+        std::size_t operator()(OrderIterator orderIt) const { return std::hash<const void*>()(&*orderIt); }
+    };
+    using OrderIteratorSet = std::unordered_set<OrderIterator, OrderIteratorHash>;
+
+    // Mutexes for each shared resource. Writers hold all three and every path
+    // acquires them in declaration order: secIdMutex, orderIdMutex, userMutex.
     mutable std::shared_mutex secIdMutex;
     mutable std::shared_mutex orderIdMutex;
     mutable std::shared_mutex userMutex;
 
     // Data structures holding orders
     std::multimap<std::string, Order> ordersBySecId;  // Maps securityId -> Order
-    std::unordered_map<std::string, std::multimap<std::string, Order>::iterator> ordersById;  // Maps orderId -> iterator in ordersBySecId
-    std::unordered_map<std::string, std::vector<std::multimap<std::string, Order>::iterator>> ordersByUser;  // Maps user -> list of order iterators
+    OrderIdIndex<std::multimap<std::string, Order>::iterator> ordersById;  // Maps orderId -> iterator in ordersBySecId
+    std::unordered_map<std::string, std::vector<std::multimap<std::string, Order>::iterator>> ordersByUser;  // Maps user -> list of order iterators, swap-removed by position
+    std::unordered_map<std::string, SecurityIndex> securityIndexes;  // Maps securityId -> qty and company aggregates
+    std::unordered_map<std::string, OrderIteratorSet> ordersBySession;  // Maps session -> its orders, guarded by userMutex
+
+    // Helper method to compute the matching qty for a security, secIdMutex must be held
+    unsigned int computeMatchingSize(const std::string& securityId) const;
+
+    // Helper method to remove orders for a security with qty >= minQty, all mutexes must be held
+    void removeOrdersForSecIdWithMinimumQty(const std::string& securityId, unsigned int minQty);
 
-    // Helper method to remove an order from the user map
+    // Helper method to remove the order in this ordersById slot, as returned by
+    // ordersById.find(), from every index and from ordersBySecId
+    void removeOrder(OrderIterator* found);
+
+    // Helper methods to add an order to and remove it from the user map
+    void addOrderToUserMap(OrderIterator orderIt);
     void removeOrderFromUserMap(const std::string& user, std::multimap<std::string, Order>::iterator orderIt);
+
+    // Helper method to remove an order from the session map
+    void removeOrderFromSessionMap(OrderIterator orderIt);
+
+    // Helper methods to keep securityIndexes in step with ordersBySecId
+    void addToSecurityIndex(OrderIterator orderIt);
+    void removeFromSecurityIndex(OrderIterator orderIt);
+    static void reduceOpenQty(SecurityIndex& index, const Order& order);
 };
\ No newline at end of file
@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "OrderCache.h"
+#include "OrderWorkload.h"
+
+// Multi-threaded stress and scaling benchmark for OrderCache.
+//
+// For every thread count T in the sweep, T writer threads each replay their own
+// generated workload (adds, cancels, cancel/replace, cancel for user, minimum
+// qty sweeps, matching queries) while T reader threads issue matching, top-N,
+// per-company and per-user queries for as long as the writers run. Users and
+// securities are shared, so bulk cancels from one writer hit other writers'
+// orders. After each run the indexes are cross-checked for consistency.
+//
+//   OrderCacheStress [--threads 1,2,4,8,16,32,64] [--ops N] [--preload N] [--seed N] [--seconds S]
+//                    [--reader-think-us N] [--require-complete]
+//
+// A run ends when every writer has replayed its --ops ops or after --seconds,
+// whichever comes first, so writer starvation shows up as lost throughput
+// rather than a hang. The "w done" column is the share of its stream that the
+// slowest writer got through; with --require-complete the exit code is
+// non-zero unless every writer finished. Readers pause --reader-think-us
+// between queries (0 runs them flat out), because std::shared_mutex may favour
+// readers and a closed loop of readers then measures writer starvation rather
+// than how the cache scales.
+//
+// Build with -fsanitize=thread to check the locking under ThreadSanitizer.
+
+namespace {
+
+constexpr std::uint32_t NUM_SECURITIES = 1000;
+constexpr std::uint32_t NUM_USERS = 1000;
+constexpr std::uint32_t NUM_COMPANIES = 100;
+
+using Clock = std::chrono::steady_clock;
+
+struct StressConfig {
+    std::vector<unsigned int> threadCounts{1, 2, 4, 8, 16, 32, 64};
+    std::uint32_t opsPerWriter = 20000;
+    std::uint32_t preload = 100000;
+    std::uint64_t seed = 1;
+    double maxSeconds = 5;  // writers stop early when a run takes longer than this
+    std::uint32_t readerThinkUs = 50;  // pause between a reader's queries
+    bool requireComplete = false;      // fail unless every writer replays its whole stream
+};
+
+// Shared security, user and company names, built once and only read by threads
+struct Names {
+    std::vector<std::string> secIds, users, companies;
+    const std::string sides[2] = {"Buy", "Sell"};
+
+    Names() {
+        for (std::uint32_t i = 0; i < NUM_SECURITIES; i++) secIds.push_back("SecId" + std::to_string(i));
+        for (std::uint32_t i = 0; i < NUM_USERS; i++) users.push_back("User" + std::to_string(i));
+        for (std::uint32_t i = 0; i < NUM_COMPANIES; i++) companies.push_back("Comp" + std::to_string(i));
+    }
+};
+
+// One writer's op stream with all strings and Orders materialized up front
+struct WriterOps {
+    std::vector<WorkloadOp> ops;
+    std::vector<std::string> orderIds;
+    std::vector<Order> addOrders;
+
+    WriterOps(const Names& names, const std::string& idPrefix, const WorkloadConfig& config)
+        : ops(generateWorkload(config)) {
+        std::uint32_t maxOrderId = 0;
+        for (const auto& op : ops) {
+            maxOrderId = std::max(maxOrderId, op.orderId);
+        }
+        for (std::uint32_t i = 0; i <= maxOrderId; i++) {
+            orderIds.push_back(idPrefix + std::to_string(i));
+        }
+        for (const auto& op : ops) {
+            if (op.type == WorkloadOpType::Add) {
+                addOrders.push_back(Order{orderIds[op.orderId], names.secIds[op.secId], names.sides[op.side & 1],
+                                          op.qty, names.users[op.user], names.companies[op.company]});
+            }
+        }
+    }
+};
+
+struct RunResult {
+    double seconds = 0;
+    std::uint64_t writerOps = 0;
+    std::uint64_t readerOps = 0;
+    double minWriterDone = 0;  // smallest fraction of its stream any writer completed
+    std::vector<std::uint64_t> writerLatencies;
+    std::vector<std::uint64_t> readerLatencies;
+    bool consistent = false;
+};
+
+WorkloadConfig writerConfig(std::uint64_t seed, std::uint32_t numOps) {
+    WorkloadConfig config;
+    config.seed = seed;
+    config.numOps = numOps;
+    config.numSecurities = NUM_SECURITIES;
+    config.numUsers = NUM_USERS;
+    config.numCompanies = NUM_COMPANIES;
+    return config;
+}
+
+std::uint64_t elapsedNs(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+std::uint64_t percentile(const std::vector<std::uint64_t>& sorted, double p) {
+    return sorted.empty() ? 0 : sorted[static_cast<std::size_t>(p * (sorted.size() - 1))];
+}
+
+void writerThread(OrderCache& cache, WriterOps& work, const Names& names, const std::atomic<bool>& go,
+                  const std::atomic<bool>& stop, std::vector<std::uint64_t>& latencies) {
+    latencies.reserve(work.ops.size());
+    while (!go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    std::size_t nextAdd = 0;
+    for (const auto& op : work.ops) {
+        if (stop.load(std::memory_order_relaxed)) {
+            break;
+        }
+        auto start = Clock::now();
+        switch (op.type) {
+            case WorkloadOpType::Add:
+                cache.addOrder(std::move(work.addOrders[nextAdd++]));
+                break;
+            case WorkloadOpType::Cancel:
+                cache.cancelOrder(work.orderIds[op.orderId]);
+                break;
+            case WorkloadOpType::CancelForUser:
+                cache.cancelOrdersForUser(names.users[op.user]);
+                break;
+            case WorkloadOpType::CancelForSecIdMinQty:
+                cache.cancelOrdersForSecIdWithMinimumQty(names.secIds[op.secId], op.qty);
+                break;
+            case WorkloadOpType::MatchQuery:
+                cache.getMatchingSizeForSecurity(names.secIds[op.secId]);
+                break;
+        }
+        latencies.push_back(elapsedNs(start));
+    }
+}
+
+void readerThread(OrderCache& cache, const Names& names, std::uint64_t seed, std::uint32_t thinkUs,
+                  const std::atomic<bool>& go, const std::atomic<bool>& stop, std::vector<std::uint64_t>& latencies) {
+    std::mt19937_64 gen(seed);
+    std::vector<Order> orders;
+    std::vector<std::pair<std::string, unsigned int>> openQty;
+    while (!go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    while (!stop.load(std::memory_order_acquire)) {
+        const auto& secId = names.secIds[gen() % NUM_SECURITIES];
+        auto start = Clock::now();
+        switch (gen() % 4) {
+            case 0:  cache.getMatchingSizeForSecurity(secId); break;
+            case 1:  cache.topOrdersByQty(secId, 20, orders); break;
+            case 2:  cache.openQtyByCompany(secId, openQty); break;
+            default: cache.getOrdersForUser(names.users[gen() % NUM_USERS], orders); break;
+        }
+        latencies.push_back(elapsedNs(start));
+        if (thinkUs > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(thinkUs));
+        }
+    }
+}
+
+// Every order must be reachable through each index exactly once
+bool checkConsistency(OrderCache& cache, const Names& names) {
+    std::size_t total = cache.getAllOrders().size();
+    std::size_t byUser = 0, bySecId = 0, byQty = 0;
+    std::vector<Order> orders;
+    for (const auto& user : names.users) {
+        cache.getOrdersForUser(user, orders);
+        byUser += orders.size();
+    }
+    for (const auto& secId : names.secIds) {
+        cache.getOrdersForSecurity(secId, orders);
+        bySecId += orders.size();
+        cache.topOrdersByQty(secId, total, orders);
+        byQty += orders.size();
+    }
+    return byUser == total && bySecId == total && byQty == total;
+}
+
+RunResult runStress(const StressConfig& config, const Names& names, unsigned int threads) {
+    OrderCache cache;
+    WorkloadConfig preloadConfig = writerConfig(config.seed, config.preload);
+    preloadConfig.cancelWeight = preloadConfig.replaceWeight = 0;
+    preloadConfig.cancelForUserWeight = preloadConfig.minQtySweepWeight = preloadConfig.matchWeight = 0;
+    WriterOps preload(names, "Pre", preloadConfig);
+    for (std::size_t i = 0; i < preload.addOrders.size(); i++) {
+        cache.addOrder(preload.addOrders[i]);
+    }
+
+    std::vector<WriterOps> work;
+    for (unsigned int t = 0; t < threads; t++) {
+        work.emplace_back(names, "W" + std::to_string(t) + "_", writerConfig(config.seed + 1 + t, config.opsPerWriter));
+    }
+
+    std::atomic<bool> go{false};
+    std::atomic<bool> stop{false};         // set once the writers finish or the time limit is hit
+    std::atomic<bool> writersDone{false};
+    std::vector<std::vector<std::uint64_t>> writerLatencies(threads), readerLatencies(threads);
+    std::vector<std::thread> writers, readers;
+    for (unsigned int t = 0; t < threads; t++) {
+        writers.emplace_back(writerThread, std::ref(cache), std::ref(work[t]), std::cref(names), std::cref(go),
+                             std::cref(stop), std::ref(writerLatencies[t]));
+        readers.emplace_back(readerThread, std::ref(cache), std::cref(names), config.seed + 1000 + t,
+                             config.readerThinkUs, std::cref(go), std::cref(stop), std::ref(readerLatencies[t]));
+    }
+
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    std::thread timer([&] {
+        auto deadline = start + std::chrono::duration<double>(config.maxSeconds);
+        while (!writersDone.load(std::memory_order_acquire) && Clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        stop.store(true, std::memory_order_release);
+    });
+    for (auto& w : writers) {
+        w.join();
+    }
+    RunResult result;
+    result.seconds = elapsedNs(start) / 1e9;
+    writersDone.store(true, std::memory_order_release);
+    timer.join();
+    for (auto& r : readers) {
+        r.join();
+    }
+
+    result.minWriterDone = 1;
+    for (unsigned int t = 0; t < threads; t++) {
+        const auto& l = writerLatencies[t];
+        if (!work[t].ops.empty()) {
+            result.minWriterDone = std::min(result.minWriterDone, static_cast<double>(l.size()) / work[t].ops.size());
+        }
+        result.writerLatencies.insert(result.writerLatencies.end(), l.begin(), l.end());
+    }
+    for (auto& l : readerLatencies) {
+        result.readerLatencies.insert(result.readerLatencies.end(), l.begin(), l.end());
+    }
+    result.writerOps = result.writerLatencies.size();
+    result.readerOps = result.readerLatencies.size();
+    std::sort(result.writerLatencies.begin(), result.writerLatencies.end());
+    std::sort(result.readerLatencies.begin(), result.readerLatencies.end());
+    result.consistent = checkConsistency(cache, names);
+    return result;
+}
+
+bool parseThreadCounts(const std::string& list, std::vector<unsigned int>& counts) {
+    counts.clear();
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        unsigned long n = std::strtoul(item.c_str(), nullptr, 10);
+        if (n == 0) {
+            return false;
+        }
+        counts.push_back(static_cast<unsigned int>(n));
+    }
+    return !counts.empty();
+}
+
+void usage(const char* argv0) {
+    std::cerr << "usage: " << argv0 << " [--threads 1,2,4,8,16,32,64] [--ops N] [--preload N] [--seed N] [--seconds S]"
+                 " [--reader-think-us N] [--require-complete]\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    StressConfig config;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--require-complete") {
+            config.requireComplete = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (arg == "--threads") {
+            if (!parseThreadCounts(value, config.threadCounts)) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--ops")     config.opsPerWriter = std::strtoul(value, nullptr, 10);
+        else if (arg == "--preload")   config.preload = std::strtoul(value, nullptr, 10);
+        else if (arg == "--seed")      config.seed = std::strtoull(value, nullptr, 10);
+        else if (arg == "--seconds")   config.maxSeconds = std::strtod(value, nullptr);
+        else if (arg == "--reader-think-us") config.readerThinkUs = std::strtoul(value, nullptr, 10);
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    Names names;
+    bool allConsistent = true;
+    bool allComplete = true;
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "write ops/s" << std::setw(14) << "read ops/s"
+              << std::setw(9) << "w done"
+              << std::setw(12) << "w p50" << std::setw(12) << "w p99" << std::setw(12) << "w p99.9"
+              << std::setw(12) << "r p50" << std::setw(12) << "r p99" << std::setw(12) << "r p99.9"
+              << "  check" << "\n";
+    for (auto threads : config.threadCounts) {
+        RunResult r = runStress(config, names, threads);
+        bool complete = r.minWriterDone >= 1;
+        allConsistent = allConsistent && r.consistent;
+        allComplete = allComplete && complete;
+        std::cout << std::setw(8) << threads
+                  << std::setw(14) << static_cast<std::uint64_t>(r.writerOps / r.seconds)
+                  << std::setw(14) << static_cast<std::uint64_t>(r.readerOps / r.seconds)
+                  << std::setw(8) << static_cast<unsigned int>(r.minWriterDone * 100) << "%"
+                  << std::setw(12) << percentile(r.writerLatencies, 0.50)
+                  << std::setw(12) << percentile(r.writerLatencies, 0.99)
+                  << std::setw(12) << percentile(r.writerLatencies, 0.999)
+                  << std::setw(12) << percentile(r.readerLatencies, 0.50)
+                  << std::setw(12) << percentile(r.readerLatencies, 0.99)
+                  << std::setw(12) << percentile(r.readerLatencies, 0.999)
+                  << "  " << (r.consistent ? "ok" : "FAILED")
+                  << (complete ? "" : ", writers timed out") << std::endl;
+    }
+    std::cout << "latencies in ns, per thread count: T writers and T readers\n";
+    if (config.requireComplete && !allComplete) {
+        std::cout << "writers did not finish within --seconds\n";
+        return 1;
+    }
+    return allConsistent ? 0 : 1;
+}
@@ -1,9 +1,14 @@
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <random>
 #include <chrono>
 #include <iostream>
+#include <thread>
+#include <cstdio>
 #include "OrderCache.h"
+#include "OrderQueryBatcher.h"
+#include "OrderWorkload.h"
 #include "gtest/gtest.h"
 
 using namespace std::chrono_literals;
@@ -402,6 +407,765 @@ TEST_F(OrderCacheTest, M2_MatchingSizeTest_MultipleMatchingCombinations) {
     ASSERT_EQ(matchingSize, 6500); // Total of 6500 (2000 from Order 2, 3000 from Order 3, 1500 from Order 5) should match with Orders 1 and 4
 }
 
+// Test Q1: Get orders for user
+TEST_F(OrderCacheTest, Q1_QueryTest_getOrdersForUser) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    cache.addOrder(Order{"1", "SecId1", "Buy", 200, "User1", "Company1"});
+    cache.addOrder(Order{"2", "SecId2", "Sell", 300, "User1", "Company1"});
+    cache.addOrder(Order{"3", "SecId1", "Buy", 400, "User2", "Company2"});
+
+    std::vector<Order> orders;
+    cache.getOrdersForUser("User1", orders);
+    ASSERT_EQ(orders.size(), 2);
+
+    cache.cancelOrder("1");
+    cache.getOrdersForUser("User1", orders);
+    ASSERT_EQ(orders.size(), 1);
+    ASSERT_EQ(orders[0].orderId(), "2");
+
+    cache.getOrdersForUser("User3", orders);
+    ASSERT_TRUE(orders.empty());
+}
+
+// Test Q2: Get orders for security
+TEST_F(OrderCacheTest, Q2_QueryTest_getOrdersForSecurity) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    cache.addOrder(Order{"1", "SecId1", "Buy", 200, "User1", "Company1"});
+    cache.addOrder(Order{"2", "SecId2", "Sell", 300, "User1", "Company1"});
+    cache.addOrder(Order{"3", "SecId1", "Sell", 400, "User2", "Company2"});
+
+    std::vector<Order> orders;
+    cache.getOrdersForSecurity("SecId1", orders);
+    ASSERT_EQ(orders.size(), 2);
+
+    cache.cancelOrdersForUser("User2");
+    cache.getOrdersForSecurity("SecId1", orders);
+    ASSERT_EQ(orders.size(), 1);
+    ASSERT_EQ(orders[0].orderId(), "1");
+
+    cache.getOrdersForSecurity("SecId3", orders);
+    ASSERT_TRUE(orders.empty());
+}
+
+// Test Q3: Top orders by quantity
+TEST_F(OrderCacheTest, Q3_QueryTest_topOrdersByQty) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    cache.addOrder(Order{"1", "SecId1", "Buy", 200, "User1", "Company1"});
+    cache.addOrder(Order{"2", "SecId1", "Sell", 500, "User2", "Company2"});
+    cache.addOrder(Order{"3", "SecId1", "Buy", 300, "User3", "Company1"});
+    cache.addOrder(Order{"4", "SecId2", "Sell", 900, "User4", "Company2"});
+
+    std::vector<Order> orders;
+    cache.topOrdersByQty("SecId1", 2, orders);
+    ASSERT_EQ(orders.size(), 2);
+    ASSERT_EQ(orders[0].orderId(), "2");
+    ASSERT_EQ(orders[1].orderId(), "3");
+
+    // Matching must not consume the quantities held by the cache
+    ASSERT_EQ(cache.getMatchingSizeForSecurity("SecId1"), 500);
+    ASSERT_EQ(cache.getMatchingSizeForSecurity("SecId1"), 500);
+
+    cache.cancelOrdersForSecIdWithMinimumQty("SecId1", 300);
+    cache.topOrdersByQty("SecId1", 10, orders);
+    ASSERT_EQ(orders.size(), 1);
+    ASSERT_EQ(orders[0].orderId(), "1");
+}
+
+// Test Q4: Open quantity per company
+TEST_F(OrderCacheTest, Q4_QueryTest_openQtyByCompany) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    cache.addOrder(Order{"1", "SecId1", "Buy", 200, "User1", "Company1"});
+    cache.addOrder(Order{"2", "SecId1", "Sell", 500, "User2", "Company2"});
+    cache.addOrder(Order{"3", "SecId1", "Buy", 300, "User3", "Company1"});
+    cache.addOrder(Order{"4", "SecId2", "Sell", 900, "User4", "Company2"});
+
+    std::vector<std::pair<std::string, unsigned int>> openQty;
+    cache.openQtyByCompany("SecId1", openQty);
+    std::sort(openQty.begin(), openQty.end());
+    ASSERT_EQ(openQty.size(), 2);
+    ASSERT_EQ(openQty[0], std::make_pair(std::string("Company1"), 500u));
+    ASSERT_EQ(openQty[1], std::make_pair(std::string("Company2"), 500u));
+
+    cache.cancelOrder("2");
+    cache.openQtyByCompany("SecId1", openQty);
+    ASSERT_EQ(openQty.size(), 1);
+    ASSERT_EQ(openQty[0], std::make_pair(std::string("Company1"), 500u));
+}
+
+// Test Q5: Cancelling from a crowded qty level keeps the level consistent
+TEST_F(OrderCacheTest, Q5_QueryTest_SameQtyLevelCancels) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    constexpr int NUM_ORDERS = 1000;
+    for (int i = 0; i < NUM_ORDERS; i++) {
+        cache.addOrder(Order{"OrdId" + std::to_string(i), "SecId1", sides[i % 2], 100, users[i % 4], companies[i % 5]});
+    }
+
+    std::vector<int> cancelOrder;
+    for (int i = 0; i < NUM_ORDERS; i++) {
+        cancelOrder.push_back(i);
+    }
+    std::shuffle(cancelOrder.begin(), cancelOrder.end(), std::mt19937(42));
+    cancelOrder.resize(NUM_ORDERS / 2 + 7);
+    for (int i : cancelOrder) {
+        cache.cancelOrder("OrdId" + std::to_string(i));
+    }
+    std::sort(cancelOrder.begin(), cancelOrder.end());
+
+    std::vector<Order> top;
+    cache.topOrdersByQty("SecId1", NUM_ORDERS, top);
+    ASSERT_EQ(top.size(), NUM_ORDERS - cancelOrder.size());
+    for (const auto& order : top) {
+        int id = std::stoi(order.orderId().substr(5));
+        ASSERT_FALSE(std::binary_search(cancelOrder.begin(), cancelOrder.end(), id));
+    }
+
+    std::vector<std::pair<std::string, unsigned int>> openQty;
+    cache.openQtyByCompany("SecId1", openQty);
+    unsigned int totalOpenQty = 0;
+    for (const auto& companyQty : openQty) {
+        totalOpenQty += companyQty.second;
+    }
+    ASSERT_EQ(totalOpenQty, top.size() * 100);
+}
+
+// Helper to build an order tagged with a session
+static Order sessionOrder(const std::string& ordId, const std::string& secId, const std::string& side,
+                          unsigned int qty, const std::string& user, const std::string& company,
+                          const std::string& session) {
+    Order order{ordId, secId, side, qty, user, company};
+    order.setSession(session);
+    return order;
+}
+
+// Test S1: Cancel all orders for a session across users and securities
+TEST_F(OrderCacheTest, S1_SessionTest_cancelOrdersForSession) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    cache.addOrder(sessionOrder("1", "SecId1", "Buy", 200, "User1", "Company1", "Gw1"));
+    cache.addOrder(sessionOrder("2", "SecId1", "Sell", 300, "User2", "Company2", "Gw1"));
+    cache.addOrder(sessionOrder("3", "SecId2", "Buy", 400, "User1", "Company1", "Gw2"));
+    cache.addOrder(sessionOrder("4", "SecId2", "Sell", 500, "User2", "Company2", "Gw1"));
+    cache.addOrder(Order{"5", "SecId1", "Buy", 600, "User1", "Company1"});
+
+    cache.cancelOrdersForSession("Gw1");
+    std::vector<Order> allOrders = cache.getAllOrders();
+    ASSERT_EQ(allOrders.size(), 2);
+
+    std::vector<Order> orders;
+    cache.getOrdersForUser("User2", orders);
+    ASSERT_TRUE(orders.empty());
+    cache.getOrdersForUser("User1", orders);
+    ASSERT_EQ(orders.size(), 2);
+
+    cache.topOrdersByQty("SecId1", 10, orders);
+    ASSERT_EQ(orders.size(), 1);
+    ASSERT_EQ(orders[0].orderId(), "5");
+
+    std::vector<std::pair<std::string, unsigned int>> openQty;
+    cache.openQtyByCompany("SecId2", openQty);
+    ASSERT_EQ(openQty.size(), 1);
+    ASSERT_EQ(openQty[0], std::make_pair(std::string("Company1"), 400u));
+
+    // Cancelling an unknown or already purged session does nothing
+    cache.cancelOrdersForSession("Gw1");
+    cache.cancelOrdersForSession("Gw3");
+    ASSERT_EQ(cache.getAllOrders().size(), 2);
+}
+
+// Test S2: Orders cancelled individually leave the session index
+TEST_F(OrderCacheTest, S2_SessionTest_CancelThenSessionCancel) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    cache.addOrder(sessionOrder("1", "SecId1", "Buy", 200, "User1", "Company1", "Gw1"));
+    cache.addOrder(sessionOrder("2", "SecId1", "Sell", 300, "User2", "Company2", "Gw1"));
+    cache.addOrder(sessionOrder("3", "SecId2", "Buy", 400, "User3", "Company1", "Gw1"));
+
+    cache.cancelOrder("1");
+    cache.cancelOrdersForUser("User2");
+    cache.cancelOrdersForSecIdWithMinimumQty("SecId2", 400);
+    ASSERT_TRUE(cache.getAllOrders().empty());
+
+    // The same ids can be reused under the session after the earlier cancels
+    cache.addOrder(sessionOrder("1", "SecId1", "Buy", 200, "User1", "Company1", "Gw1"));
+    cache.cancelOrdersForSession("Gw1");
+    ASSERT_TRUE(cache.getAllOrders().empty());
+}
+
+// Test S3: Session orders mixed into a crowded user list and qty level leave the rest intact
+TEST_F(OrderCacheTest, S3_SessionTest_PurgeAmongResidentOrders) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    for (int i = 0; i < 300; i++) {
+        std::string orderId = "OrdId" + std::to_string(i);
+        if (i % 3 == 0) {
+            cache.addOrder(sessionOrder(orderId, "SecId1", sides[i % 2], 100, "User1", companies[i % 5], "Gw1"));
+        } else {
+            cache.addOrder(Order{orderId, "SecId1", sides[i % 2], 100, "User1", companies[i % 5]});
+        }
+    }
+
+    cache.cancelOrdersForSession("Gw1");
+
+    std::vector<Order> orders;
+    cache.getOrdersForUser("User1", orders);
+    ASSERT_EQ(orders.size(), 200);
+    for (const auto& order : orders) {
+        ASSERT_NE(std::stoi(order.orderId().substr(5)) % 3, 0);
+    }
+    cache.topOrdersByQty("SecId1", 1000, orders);
+    ASSERT_EQ(orders.size(), 200);
+
+    // The survivors' recorded positions still let them be cancelled one by one
+    for (int i = 0; i < 300; i++) {
+        if (i % 3 != 0) {
+            cache.cancelOrder("OrdId" + std::to_string(i));
+        }
+    }
+    ASSERT_TRUE(cache.getAllOrders().empty());
+    cache.getOrdersForUser("User1", orders);
+    ASSERT_TRUE(orders.empty());
+}
+
+// Test A1: Amend order quantity in place
+TEST_F(OrderCacheTest, A1_AmendTest_amendOrderQty) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    cache.addOrder(Order{"1", "SecId1", "Buy", 1000, "User1", "CompanyA"});
+    cache.addOrder(Order{"2", "SecId1", "Sell", 400, "User2", "CompanyB"});
+    cache.addOrder(Order{"3", "SecId1", "Sell", 300, "User3", "CompanyC"});
+    ASSERT_EQ(cache.getMatchingSizeForSecurity("SecId1"), 700);
+
+    // Reduce, then increase
+    ASSERT_TRUE(cache.amendOrderQty("1", 500));
+    ASSERT_EQ(cache.getMatchingSizeForSecurity("SecId1"), 500);
+    ASSERT_TRUE(cache.amendOrderQty("3", 900));
+
+    std::vector<Order> orders;
+    cache.topOrdersByQty("SecId1", 1, orders);
+    ASSERT_EQ(orders.size(), 1);
+    ASSERT_EQ(orders[0].orderId(), "3");
+    ASSERT_EQ(orders[0].qty(), 900);
+
+    std::vector<std::pair<std::string, unsigned int>> openQty;
+    cache.openQtyByCompany("SecId1", openQty);
+    std::sort(openQty.begin(), openQty.end());
+    ASSERT_EQ(openQty.size(), 3);
+    ASSERT_EQ(openQty[0], std::make_pair(std::string("CompanyA"), 500u));
+    ASSERT_EQ(openQty[2], std::make_pair(std::string("CompanyC"), 900u));
+
+    // Amending to zero cancels, unknown ids are reported
+    ASSERT_TRUE(cache.amendOrderQty("2", 0));
+    ASSERT_EQ(cache.getAllOrders().size(), 2);
+    ASSERT_FALSE(cache.amendOrderQty("2", 100));
+
+    cache.cancelOrdersForSecIdWithMinimumQty("SecId1", 600);
+    orders = cache.getAllOrders();
+    ASSERT_EQ(orders.size(), 1);
+    ASSERT_EQ(orders[0].orderId(), "1");
+}
+
+// Test A2: Replace an order keeping the same security
+TEST_F(OrderCacheTest, A2_AmendTest_replaceOrderSameSecurity) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    cache.addOrder(Order{"1", "SecId1", "Buy", 1000, "User1", "CompanyA"});
+    cache.addOrder(Order{"2", "SecId1", "Sell", 400, "User2", "CompanyB"});
+
+    // New id, user and company on the same security
+    ASSERT_TRUE(cache.replaceOrder("2", Order{"2a", "SecId1", "Sell", 600, "User3", "CompanyC"}));
+    ASSERT_EQ(cache.getAllOrders().size(), 2);
+    ASSERT_EQ(cache.getMatchingSizeForSecurity("SecId1"), 600);
+
+    std::vector<Order> orders;
+    cache.getOrdersForUser("User2", orders);
+    ASSERT_TRUE(orders.empty());
+    cache.getOrdersForUser("User3", orders);
+    ASSERT_EQ(orders.size(), 1);
+    ASSERT_EQ(orders[0].orderId(), "2a");
+
+    // The old id is gone, the new one cancels
+    ASSERT_FALSE(cache.replaceOrder("2", Order{"2b", "SecId1", "Sell", 100, "User3", "CompanyC"}));
+    ASSERT_FALSE(cache.replaceOrder("1", Order{"2a", "SecId1", "Buy", 100, "User1", "CompanyA"}));
+    cache.cancelOrder("2a");
+    orders = cache.getAllOrders();
+    ASSERT_EQ(orders.size(), 1);
+    ASSERT_EQ(orders[0].orderId(), "1");
+}
+
+// Test A3: Replace an order onto another security
+TEST_F(OrderCacheTest, A3_AmendTest_replaceOrderNewSecurity) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    cache.addOrder(sessionOrder("1", "SecId1", "Buy", 1000, "User1", "CompanyA", "Gw1"));
+    cache.addOrder(Order{"2", "SecId2", "Sell", 400, "User2", "CompanyB"});
+
+    ASSERT_TRUE(cache.replaceOrder("1", sessionOrder("1", "SecId2", "Buy", 700, "User1", "CompanyA", "Gw1")));
+    ASSERT_EQ(cache.getMatchingSizeForSecurity("SecId1"), 0);
+    ASSERT_EQ(cache.getMatchingSizeForSecurity("SecId2"), 400);
+
+    std::vector<Order> orders;
+    cache.getOrdersForSecurity("SecId1", orders);
+    ASSERT_TRUE(orders.empty());
+    cache.topOrdersByQty("SecId2", 10, orders);
+    ASSERT_EQ(orders.size(), 2);
+    ASSERT_EQ(orders[0].orderId(), "1");
+
+    cache.cancelOrdersForSession("Gw1");
+    orders = cache.getAllOrders();
+    ASSERT_EQ(orders.size(), 1);
+    ASSERT_EQ(orders[0].orderId(), "2");
+}
+
+// Test A4: A replace without a session tag keeps the replaced order's session
+TEST_F(OrderCacheTest, A4_AmendTest_replaceOrderKeepsSession) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    cache.addOrder(sessionOrder("1", "SecId1", "Buy", 200, "User1", "Company1", "Gw1"));
+    cache.addOrder(sessionOrder("2", "SecId1", "Sell", 300, "User2", "Company2", "Gw1"));
+
+    ASSERT_TRUE(cache.replaceOrder("1", Order{"1a", "SecId1", "Buy", 250, "User1", "Company1"}));
+    ASSERT_TRUE(cache.replaceOrder("2", Order{"2", "SecId2", "Sell", 300, "User2", "Company2"}));
+
+    std::vector<Order> allOrders = cache.getAllOrders();
+    ASSERT_EQ(allOrders.size(), 2);
+    for (const auto& order : allOrders) {
+        ASSERT_EQ(order.session(), "Gw1");
+    }
+
+    cache.cancelOrdersForSession("Gw1");
+    ASSERT_TRUE(cache.getAllOrders().empty());
+}
+
+// Test A6: Replacing an order inside a user's list keeps that list intact
+TEST_F(OrderCacheTest, A6_AmendTest_replaceOrderMidUserList) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    cache.addOrder(Order{"a", "SecId1", "Buy", 10, "User1", "Company1"});
+    cache.addOrder(Order{"b", "SecId1", "Buy", 20, "User1", "Company1"});
+    cache.addOrder(Order{"c", "SecId1", "Buy", 30, "User1", "Company1"});
+    cache.addOrder(Order{"d", "SecId1", "Sell", 40, "User1", "Company1"});
+
+    ASSERT_TRUE(cache.replaceOrder("c", Order{"c", "SecId1", "Buy", 31, "User1", "Company1"}));
+    cache.cancelOrder("c");
+
+    // A copy read back from the cache must not carry index state into a replace
+    std::vector<Order> allOrders = cache.getAllOrders();
+    auto b = std::find_if(allOrders.begin(), allOrders.end(), [](const Order& order) { return order.orderId() == "b"; });
+    ASSERT_NE(b, allOrders.end());
+    auto d = std::find_if(allOrders.begin(), allOrders.end(), [](const Order& order) { return order.orderId() == "d"; });
+    ASSERT_NE(d, allOrders.end());
+    ASSERT_TRUE(cache.replaceOrder("d", *d));
+    ASSERT_TRUE(cache.replaceOrder("b", *b));
+    cache.cancelOrder("b");
+
+    std::vector<Order> orders;
+    cache.getOrdersForUser("User1", orders);
+    ASSERT_EQ(orders.size(), 2);
+    cache.topOrdersByQty("SecId1", 10, orders);
+    ASSERT_EQ(orders.size(), 2);
+
+    cache.cancelOrdersForUser("User1");
+    ASSERT_TRUE(cache.getAllOrders().empty());
+    cache.getOrdersForUser("User1", orders);
+    ASSERT_TRUE(orders.empty());
+}
+
+// Test A5: Replacing or amending to qty 0 cancels the order
+TEST_F(OrderCacheTest, A5_AmendTest_ZeroQtyCancels) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    cache.addOrder(Order{"1", "SecId1", "Buy", 200, "User1", "Company1"});
+    cache.addOrder(Order{"2", "SecId1", "Sell", 300, "User2", "Company2"});
+    cache.addOrder(Order{"3", "SecId1", "Sell", 100, "User3", "Company3"});
+
+    ASSERT_TRUE(cache.replaceOrder("1", Order{"1", "SecId1", "Buy", 0, "User1", "Company1"}));
+    ASSERT_TRUE(cache.amendOrderQty("2", 0));
+    ASSERT_FALSE(cache.replaceOrder("1", Order{"1", "SecId1", "Buy", 0, "User1", "Company1"}));
+
+    std::vector<Order> allOrders = cache.getAllOrders();
+    ASSERT_EQ(allOrders.size(), 1);
+    ASSERT_EQ(allOrders[0].orderId(), "3");
+
+    std::vector<Order> orders;
+    cache.getOrdersForUser("User1", orders);
+    ASSERT_TRUE(orders.empty());
+    cache.topOrdersByQty("SecId1", 10, orders);
+    ASSERT_EQ(orders.size(), 1);
+}
+
+// Test H1: Order id index insert, find, erase and growth
+TEST_F(OrderCacheTest, H1_IndexTest_OrderIdIndex) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    OrderIdIndex<int> index;
+    constexpr int NUM_IDS = 50000;
+    const std::string longPrefix = "AVeryLongOrderIdentifierPrefix_";  // longer than the inline id size
+
+    for (int i = 0; i < NUM_IDS; i++) {
+        index.insertOrAssign("OrdId" + std::to_string(i), i);
+        index.insertOrAssign(longPrefix + std::to_string(i), -i);
+    }
+    ASSERT_EQ(index.size(), 2 * NUM_IDS);
+
+    // Re-inserting an id replaces its value
+    index.insertOrAssign("OrdId7", 700);
+    ASSERT_EQ(index.size(), 2 * NUM_IDS);
+    ASSERT_EQ(*index.find("OrdId7"), 700);
+
+    for (int i = 0; i < NUM_IDS; i += 2) {
+        ASSERT_TRUE(index.erase("OrdId" + std::to_string(i)));
+        ASSERT_TRUE(index.erase(longPrefix + std::to_string(i)));
+    }
+    ASSERT_FALSE(index.erase("OrdId0"));
+    ASSERT_EQ(index.size(), NUM_IDS);
+
+    for (int i = 1; i < NUM_IDS; i += 2) {
+        std::string id = "OrdId" + std::to_string(i);
+        const int* value = index.find(id, OrderIdIndex<int>::hashId(id));
+        ASSERT_NE(value, nullptr);
+        ASSERT_EQ(*value, i == 7 ? 700 : i);
+        ASSERT_EQ(*index.find(longPrefix + std::to_string(i)), -i);
+        ASSERT_EQ(index.find("OrdId" + std::to_string(i - 1)), nullptr);
+    }
+
+    // Erasing through the pointer find() returned removes just that entry
+    for (int i = 1; i < NUM_IDS; i += 4) {
+        index.erase(index.find(longPrefix + std::to_string(i)));
+    }
+    for (int i = 1; i < NUM_IDS; i += 2) {
+        const int* value = index.find(longPrefix + std::to_string(i));
+        if (i % 4 == 1) {
+            ASSERT_EQ(value, nullptr);
+        } else {
+            ASSERT_NE(value, nullptr);
+            ASSERT_EQ(*value, -i);
+        }
+    }
+    ASSERT_EQ(index.size(), NUM_IDS - NUM_IDS / 4);
+}
+
+// Test B1: Cancel a batch of orders
+TEST_F(OrderCacheTest, B1_BatchTest_cancelOrders) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    for (int i = 0; i < 100; i++) {
+        cache.addOrder(Order{"OrdId" + std::to_string(i), secIds[i % 3], sides[i % 2], 100,
+                             users[i % 4], companies[i % 5]});
+    }
+
+    std::vector<std::string> ids;
+    for (int i = 0; i < 100; i += 2) {
+        ids.push_back("OrdId" + std::to_string(i));
+    }
+    ids.push_back("NonExistentOrder");
+    ids.push_back("OrdId0");  // already cancelled earlier in the same batch
+    cache.cancelOrders(ids);
+
+    std::vector<Order> allOrders = cache.getAllOrders();
+    ASSERT_EQ(allOrders.size(), 50);
+    for (const auto& order : allOrders) {
+        ASSERT_EQ(std::stoi(order.orderId().substr(5)) % 2, 1);
+    }
+
+    std::vector<Order> orders;
+    cache.getOrdersForUser(users[0], orders);
+    ASSERT_TRUE(orders.empty());
+}
+
+// Test R1: Reserving up front keeps the id index from growing as orders arrive
+TEST_F(OrderCacheTest, R1_MemoryTest_reserve) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    OrderCacheMemoryUsage empty = cache.memoryUsage();
+    cache.reserve(1000, 3, 4, 64);
+    OrderCacheMemoryUsage reserved = cache.memoryUsage();
+    ASSERT_GT(reserved.ordersById, 0);
+    ASSERT_GT(reserved.ordersBySession, empty.ordersBySession);
+    ASSERT_EQ(reserved.ordersBySecId, 0);
+
+    for (int i = 0; i < 1000; i++) {
+        cache.addOrder(Order{"OrdId" + std::to_string(i), secIds[i % 3], sides[i % 2], 100,
+                             users[i % 4], companies[i % 5]});
+    }
+
+    OrderCacheMemoryUsage filled = cache.memoryUsage();
+    ASSERT_EQ(filled.ordersById, reserved.ordersById);
+    ASSERT_GT(filled.ordersBySecId, 0);
+    ASSERT_GT(filled.ordersByUser, reserved.ordersByUser);
+    ASSERT_GT(filled.securityIndexes, reserved.securityIndexes);
+    ASSERT_EQ(cache.getAllOrders().size(), 1000);
+}
+
+// Test R2: Memory usage tracks orders and long strings, and is released on cancel
+TEST_F(OrderCacheTest, R2_MemoryTest_memoryUsage) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    OrderCacheMemoryUsage empty = cache.memoryUsage();
+    ASSERT_EQ(empty.ordersBySecId, 0);
+    ASSERT_EQ(empty.strings, 0);
+
+    std::string longUser(64, 'U');
+    std::string longSession(48, 'S');
+    for (int i = 0; i < 10; i++) {
+        Order order{"OrdId" + std::to_string(i), "SecId1", sides[i % 2], 100, longUser, "CompanyA"};
+        order.setSession(longSession);
+        cache.addOrder(order);
+    }
+
+    OrderCacheMemoryUsage usage = cache.memoryUsage();
+    // every order holds both long strings, plus one copy of each as a map key
+    ASSERT_GE(usage.strings, 11 * (longUser.size() + longSession.size()));
+    ASSERT_GT(usage.ordersBySession, empty.ordersBySession);
+    ASSERT_EQ(usage.total(), usage.ordersBySecId + usage.ordersById + usage.ordersByUser +
+                             usage.securityIndexes + usage.ordersBySession + usage.strings);
+
+    cache.cancelOrdersForUser(longUser);
+    OrderCacheMemoryUsage cancelled = cache.memoryUsage();
+    ASSERT_EQ(cancelled.ordersBySecId, 0);
+    ASSERT_EQ(cancelled.strings, 0);
+}
+
+// Test F1: Batched and bulk matching agree with the per-call query
+TEST_F(OrderCacheTest, F1_BatchedQueryTest_getMatchingSizeForSecurity) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    for (int i = 0; i < 300; i++) {
+        cache.addOrder(Order{"OrdId" + std::to_string(i), secIds[i % 3], sides[i % 2], static_cast<unsigned int>(100 + i),
+                             users[i % 4], companies[i % 5]});
+    }
+
+    std::vector<std::string> querySecIds = {"SecId2", "SecId1", "SecId2", "NoSuchSecId", "SecId3"};
+    std::vector<unsigned int> sizes;
+    cache.getMatchingSizesForSecurities(querySecIds, sizes);
+    ASSERT_EQ(sizes.size(), querySecIds.size());
+    for (std::size_t i = 0; i < querySecIds.size(); i++) {
+        ASSERT_EQ(sizes[i], cache.getMatchingSizeForSecurity(querySecIds[i]));
+    }
+    ASSERT_EQ(sizes[3], 0);
+
+    OrderQueryBatcher batcher(cache);
+    std::vector<std::future<unsigned int>> results;
+    for (const auto& secId : querySecIds) {
+        results.push_back(batcher.getMatchingSizeForSecurity(secId));
+    }
+    for (std::size_t i = 0; i < querySecIds.size(); i++) {
+        ASSERT_EQ(results[i].get(), sizes[i]);
+    }
+}
+
+// Test F2: Batched requests are served in submission order
+TEST_F(OrderCacheTest, F2_BatchedQueryTest_CancelThenMatch) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    cache.addOrder(Order{"OrdId1", "SecId1", "Buy", 500, "User1", "CompanyA"});
+    cache.addOrder(Order{"OrdId2", "SecId1", "Sell", 300, "User2", "CompanyB"});
+    cache.addOrder(Order{"OrdId3", "SecId1", "Sell", 100, "User3", "CompanyC"});
+    cache.addOrder(Order{"OrdId4", "SecId2", "Buy", 200, "User1", "CompanyA"});
+    cache.addOrder(Order{"OrdId5", "SecId2", "Sell", 200, "User2", "CompanyB"});
+
+    std::future<unsigned int> before;
+    std::future<void> cancelled;
+    std::future<void> cancelledAgain;
+    std::future<unsigned int> after;
+    std::future<unsigned int> untouched;
+    {
+        OrderQueryBatcher batcher(cache);
+        before = batcher.getMatchingSizeForSecurity("SecId1");
+        cancelled = batcher.cancelOrdersForSecIdWithMinimumQty("SecId1", 400);
+        cancelledAgain = batcher.cancelOrdersForSecIdWithMinimumQty("SecId1", 250);
+        after = batcher.getMatchingSizeForSecurity("SecId1");
+        untouched = batcher.getMatchingSizeForSecurity("SecId2");
+    }  // the destructor serves everything submitted
+
+    ASSERT_EQ(before.get(), 400);
+    cancelled.get();
+    cancelledAgain.get();
+    ASSERT_EQ(after.get(), 0);
+    ASSERT_EQ(untouched.get(), 200);
+
+    std::vector<Order> allOrders = cache.getAllOrders();
+    ASSERT_EQ(allOrders.size(), 3);
+}
+
+// Test F3: Many in-process clients submitting concurrently all get their results
+TEST_F(OrderCacheTest, F3_BatchedQueryTest_ConcurrentClients) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    for (int i = 0; i < 600; i++) {
+        cache.addOrder(Order{"OrdId" + std::to_string(i), "SecId" + std::to_string(i % 20), sides[i % 2], static_cast<unsigned int>(10 + i % 50),
+                             users[i % 4], companies[i % 5]});
+    }
+    std::vector<unsigned int> expected;
+    for (int s = 0; s < 20; s++) {
+        expected.push_back(cache.getMatchingSizeForSecurity("SecId" + std::to_string(s)));
+    }
+
+    OrderQueryBatcher batcher(cache, 64);
+    constexpr int NUM_CLIENTS = 8;
+    constexpr int QUERIES_PER_CLIENT = 500;
+    std::vector<int> mismatches(NUM_CLIENTS, 0);
+    std::vector<std::thread> clients;
+    for (int c = 0; c < NUM_CLIENTS; c++) {
+        clients.emplace_back([&, c] {
+            std::vector<std::future<unsigned int>> results;
+            for (int q = 0; q < QUERIES_PER_CLIENT; q++) {
+                results.push_back(batcher.getMatchingSizeForSecurity("SecId" + std::to_string((c + q) % 20)));
+            }
+            for (int q = 0; q < QUERIES_PER_CLIENT; q++) {
+                if (results[q].get() != expected[(c + q) % 20]) {
+                    mismatches[c]++;
+                }
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    for (int c = 0; c < NUM_CLIENTS; c++) {
+        ASSERT_EQ(mismatches[c], 0);
+    }
+}
+
+// Test W1: Generated workloads are reproducible and survive a file round trip
+TEST_F(OrderCacheTest, W1_WorkloadTest_GenerateAndRoundTrip) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    WorkloadConfig config;
+    config.numOps = 20000;
+    std::vector<WorkloadOp> ops = generateWorkload(config);
+    ASSERT_EQ(ops.size(), config.numOps);
+
+    std::vector<WorkloadOp> again = generateWorkload(config);
+    ASSERT_EQ(again.size(), ops.size());
+    for (size_t i = 0; i < ops.size(); i++) {
+        ASSERT_EQ(ops[i].type, again[i].type);
+        ASSERT_EQ(ops[i].orderId, again[i].orderId);
+        ASSERT_EQ(ops[i].secId, again[i].secId);
+        ASSERT_EQ(ops[i].qty, again[i].qty);
+    }
+
+    const std::string path = "OrderCacheTest_workload.bin";
+    ASSERT_TRUE(writeWorkload(path, ops));
+    std::vector<WorkloadOp> loaded;
+    ASSERT_TRUE(readWorkload(path, loaded));
+    std::remove(path.c_str());
+
+    ASSERT_EQ(loaded.size(), ops.size());
+    for (size_t i = 0; i < ops.size(); i++) {
+        ASSERT_EQ(loaded[i].type, ops[i].type);
+        ASSERT_EQ(loaded[i].side, ops[i].side);
+        ASSERT_EQ(loaded[i].orderId, ops[i].orderId);
+        ASSERT_EQ(loaded[i].secId, ops[i].secId);
+        ASSERT_EQ(loaded[i].user, ops[i].user);
+        ASSERT_EQ(loaded[i].company, ops[i].company);
+        ASSERT_EQ(loaded[i].qty, ops[i].qty);
+    }
+}
+
+// Test W2: Replaying a mixed workload times every op
+TEST_F(OrderCacheTest, W2_WorkloadTest_Replay) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    WorkloadConfig config;
+    config.numOps = 20000;
+    std::vector<WorkloadOp> ops = generateWorkload(config);
+
+    WorkloadReplayReport report = replayWorkload(cache, ops);
+    uint64_t replayed = 0;
+    for (const auto& stats : report.perOp) {
+        replayed += stats.count;
+    }
+    ASSERT_EQ(replayed, ops.size());
+    ASSERT_GT(report.perOp[static_cast<size_t>(WorkloadOpType::Cancel)].count, 0);
+    ASSERT_GT(report.perOp[static_cast<size_t>(WorkloadOpType::MatchQuery)].count, 0);
+}
+
+// Test W3: A seed always yields the same stream, whatever the compiler
+TEST_F(OrderCacheTest, W3_WorkloadTest_PinnedStream) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    WorkloadConfig config;
+    config.seed = 7;
+    config.numOps = 1000;
+    config.numSecurities = 50;
+    config.numUsers = 40;
+    config.numCompanies = 10;
+
+    // FNV-1a over every field of every op
+    std::uint64_t hash = 1469598103934665603ull;
+    for (const auto& op : generateWorkload(config)) {
+        for (std::uint64_t field : {std::uint64_t(op.type), std::uint64_t(op.side), std::uint64_t(op.orderId),
+                                    std::uint64_t(op.secId), std::uint64_t(op.user), std::uint64_t(op.company),
+                                    std::uint64_t(op.qty)}) {
+            hash ^= field;
+            hash *= 1099511628211ull;
+        }
+    }
+    ASSERT_EQ(hash, 16472745736379682780ull);
+}
+
+// Test T1: Concurrent writers and readers leave the indexes consistent
+TEST_F(OrderCacheTest, T1_ConcurrencyTest_WritersAndReaders) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    constexpr int NUM_WRITERS = 4;
+    constexpr int ORDERS_PER_WRITER = 2000;
+    std::atomic<bool> writersDone{false};
+
+    std::vector<std::thread> writers;
+    for (int w = 0; w < NUM_WRITERS; w++) {
+        writers.emplace_back([this, w] {
+            for (int i = 0; i < ORDERS_PER_WRITER; i++) {
+                std::string id = "W" + std::to_string(w) + "_" + std::to_string(i);
+                cache.addOrder(Order{id, secIds[i % 10], sides[i % 2], 100u * (i % 7 + 1),
+                                     users[(w * 7 + i) % 20], companies[i % 5]});
+                if (i % 3 == 0) {
+                    cache.cancelOrder(id);
+                }
+                if (i % 500 == 499) {
+                    cache.cancelOrdersForUser(users[w]);
+                    cache.cancelOrdersForSecIdWithMinimumQty(secIds[w], 600);
+                }
+            }
+        });
+    }
+
+    std::thread reader([this, &writersDone] {
+        std::vector<Order> orders;
+        while (!writersDone) {
+            cache.getMatchingSizeForSecurity(secIds[1]);
+            cache.topOrdersByQty(secIds[2], 5, orders);
+            cache.getOrdersForUser(users[3], orders);
+        }
+    });
+
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    writersDone = true;
+    reader.join();
+
+    size_t total = cache.getAllOrders().size();
+    size_t byUser = 0, bySecId = 0;
+    std::vector<Order> orders;
+    for (const auto& user : users) {
+        cache.getOrdersForUser(user, orders);
+        byUser += orders.size();
+    }
+    for (const auto& secId : secIds) {
+        cache.getOrdersForSecurity(secId, orders);
+        bySecId += orders.size();
+    }
+    ASSERT_GT(total, 0);
+    ASSERT_EQ(byUser, total);
+    ASSERT_EQ(bySecId, total);
+}
+
 // Test P1: Add and match 1,000 orders
 TEST_F(OrderCacheTest, P1_PerfTest_1000_Orders) {
     CHECK_GLOBAL_FAILURE_FLAG();
@@ -591,6 +1355,92 @@ TEST_F(OrderCacheTest, P7_PerfTest_1000000_Orders) {
     ASSERT_LE(ncu, 1500);
 }
 
+// Test P8: Add 160,000 orders at one qty on one security, then cancel them one by one
+TEST_F(OrderCacheTest, P8_PerfTest_160000_SameQtyCancels) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    unsigned int NUM_ORDERS = 160000;
+    std::vector<std::string> orderIds;
+    for (unsigned int i = 0; i < NUM_ORDERS; i++) {
+        orderIds.push_back("OrdId" + std::to_string(i));
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (unsigned int i = 0; i < NUM_ORDERS; i++) {
+        cache.addOrder(Order{orderIds[i], "SecId1", sides[i % 2], 100, users[i % users.size()], companies[i % companies.size()]});
+    }
+    for (const auto& orderId : orderIds) {
+        cache.cancelOrder(orderId);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    double ncu = duration / benchmark_time;  // Calculate the NCU based on benchmark
+
+    // Display the result
+    std::cout << BLUE_COLOR << "[     INFO ] Added and cancelled " << NUM_ORDERS << " same-qty orders in " << ncu << " NCUs (" << duration << "ms)" << RESET_COLOR << std::endl;
+    ASSERT_TRUE(cache.getAllOrders().empty());
+    ASSERT_LE(ncu, 300);
+}
+
+// Test P9: Purge 1,000 one-order sessions whose user and qty level hold 100,000 other orders
+TEST_F(OrderCacheTest, P9_PerfTest_SessionPurgeAmongResidentOrders) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    unsigned int NUM_RESIDENT = 100000;
+    unsigned int NUM_SESSIONS = 1000;
+    for (unsigned int i = 0; i < NUM_RESIDENT; i++) {
+        cache.addOrder(Order{"OrdId" + std::to_string(i), "SecId1", sides[i % 2], 100, "User1", companies[i % companies.size()]});
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (unsigned int i = 0; i < NUM_SESSIONS; i++) {
+        std::string session = "Gw" + std::to_string(i);
+        cache.addOrder(sessionOrder("SessionOrd" + std::to_string(i), "SecId1", "Buy", 100, "User1", "Company1", session));
+        cache.cancelOrdersForSession(session);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    double ncu = duration / benchmark_time;  // Calculate the NCU based on benchmark
+
+    // Display the result
+    std::cout << BLUE_COLOR << "[     INFO ] Purged " << NUM_SESSIONS << " sessions among " << NUM_RESIDENT << " orders in " << ncu << " NCUs (" << duration << "ms)" << RESET_COLOR << std::endl;
+    ASSERT_EQ(cache.getAllOrders().size(), NUM_RESIDENT);
+    ASSERT_LE(ncu, 10);
+}
+
+// Test P10: Add 160,000 orders at one qty on one security, then amend each to a new qty
+TEST_F(OrderCacheTest, P10_PerfTest_160000_SameQtyAmends) {
+    CHECK_GLOBAL_FAILURE_FLAG();
+
+    unsigned int NUM_ORDERS = 160000;
+    std::vector<std::string> orderIds;
+    for (unsigned int i = 0; i < NUM_ORDERS; i++) {
+        orderIds.push_back("OrdId" + std::to_string(i));
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (unsigned int i = 0; i < NUM_ORDERS; i++) {
+        cache.addOrder(Order{orderIds[i], "SecId1", sides[i % 2], 100, users[i % users.size()], companies[i % companies.size()]});
+    }
+    for (const auto& orderId : orderIds) {
+        cache.amendOrderQty(orderId, 200);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    double ncu = duration / benchmark_time;  // Calculate the NCU based on benchmark
+
+    // Display the result
+    std::cout << BLUE_COLOR << "[     INFO ] Added and amended " << NUM_ORDERS << " same-qty orders in " << ncu << " NCUs (" << duration << "ms)" << RESET_COLOR << std::endl;
+    std::vector<Order> top;
+    cache.topOrdersByQty("SecId1", 1, top);
+    ASSERT_EQ(top.size(), 1);
+    ASSERT_EQ(top[0].qty(), 200);
+    ASSERT_LE(ncu, 300);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
 
@@ -0,0 +1,246 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Open-addressing hash index from order id to Value, using Robin Hood probing
+// with backward-shift deletion.
+//
+// Each slot is 32 bytes: the value, a 16-bit hash tag, the probe distance and
+// the id itself. Ids up to INLINE_ID_SIZE chars are stored inline, so a lookup
+// for a typical id touches a single slot and never leaves the table; longer ids
+// live in a separate heap block owned by the slot. Lookups can take a hash
+// computed up front with hashId(), and prefetch() lets batched callers start the
+// slot loads before they are needed.
+//
+// Pointers returned by find() are invalidated by any insert or erase, but can be
+// handed straight back to erase() to remove that entry without probing again.
+template <typename Value>
+class OrderIdIndex
+{
+    static_assert(std::is_trivially_copyable_v<Value>, "OrderIdIndex values are moved between slots bytewise");
+
+public:
+    static constexpr std::size_t INLINE_ID_SIZE = 16;
+
+    OrderIdIndex() = default;
+    OrderIdIndex(const OrderIdIndex&) = delete;
+    OrderIdIndex& operator=(const OrderIdIndex&) = delete;
+    ~OrderIdIndex() { clear(); }
+
+    static std::uint64_t hashId(std::string_view id) {
+        std::uint64_t h = 0x9E3779B97F4A7C15ull ^ id.size();
+        std::size_t i = 0;
+        for (; i + 8 <= id.size(); i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, id.data() + i, 8);
+            h = mix(h ^ word);
+        }
+        std::uint64_t tail = 0;
+        std::memcpy(&tail, id.data() + i, id.size() - i);
+        return mix(h ^ tail);
+    }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    std::size_t capacity() const { return slots.size(); }
+    std::size_t memoryUsage() const { return slots.size() * sizeof(Slot) + heapIdBytes; }
+
+    // Start loading the home slot for this hash into cache
+    void prefetch(std::uint64_t hash) const {
+#if defined(__GNUC__) || defined(__clang__)
+        if (!slots.empty()) {
+            __builtin_prefetch(&slots[hash & mask]);
+        }
+#else
+        (void)hash;
+#endif
+    }
+
+    Value* find(std::string_view id) { return find(id, hashId(id)); }
+    const Value* find(std::string_view id) const { return find(id, hashId(id)); }
+    bool contains(std::string_view id) const { return find(id) != nullptr; }
+
+    Value* find(std::string_view id, std::uint64_t hash) {
+        return const_cast<Value*>(static_cast<const OrderIdIndex*>(this)->find(id, hash));
+    }
+
+    const Value* find(std::string_view id, std::uint64_t hash) const {
+        std::size_t pos = findSlot(id, hash);
+        return pos == NOT_FOUND ? nullptr : &slots[pos].value;
+    }
+
+    // Map id to value, replacing any existing value
+    void insertOrAssign(std::string_view id, const Value& value) {
+        std::uint64_t hash = hashId(id);
+        if (Value* existing = find(id, hash)) {
+            *existing = value;
+            return;
+        }
+        if ((count + 1) * MAX_LOAD_DEN > slots.size() * MAX_LOAD_NUM) {
+            rehash(slots.empty() ? MIN_CAPACITY : slots.size() * 2);
+        }
+
+        Slot incoming{};
+        incoming.value = value;
+        incoming.tag = tagOf(hash);
+        incoming.length = static_cast<std::uint32_t>(id.size());
+        if (id.size() <= INLINE_ID_SIZE) {
+            std::memcpy(incoming.inlineId, id.data(), id.size());
+        } else {
+            incoming.heapId = new char[id.size()];
+            std::memcpy(incoming.heapId, id.data(), id.size());
+            heapIdBytes += id.size();
+        }
+        place(incoming, hash);
+        count++;
+    }
+
+    bool erase(std::string_view id) { return erase(id, hashId(id)); }
+
+    bool erase(std::string_view id, std::uint64_t hash) {
+        std::size_t pos = findSlot(id, hash);
+        if (pos == NOT_FOUND) {
+            return false;
+        }
+        eraseSlot(pos);
+        return true;
+    }
+
+    // Erase the entry whose value find() just returned
+    void erase(const Value* found) {
+        // value is the first member, so the address identifies its slot
+        static_assert(std::is_standard_layout_v<Slot>, "Slot must share its address with its value");
+        eraseSlot(reinterpret_cast<const Slot*>(found) - slots.data());
+    }
+
+    // Size the table so that expectedIds fit without rehashing
+    void reserve(std::size_t expectedIds) {
+        std::size_t needed = MIN_CAPACITY;
+        while (expectedIds * MAX_LOAD_DEN > needed * MAX_LOAD_NUM) {
+            needed *= 2;
+        }
+        if (needed > slots.size()) {
+            rehash(needed);
+        }
+    }
+
+    void clear() {
+        for (auto& slot : slots) {
+            if (slot.dist != 0) {
+                releaseId(slot);
+            }
+        }
+        slots.clear();
+        mask = 0;
+        count = 0;
+    }
+
+private:
+    struct Slot {
+        Value value;
+        std::uint16_t tag;     // upper hash bits, checked before comparing ids
+        std::uint16_t dist;    // probe distance + 1, 0 when the slot is empty
+        std::uint32_t length;  // id length
+        union {
+            char inlineId[INLINE_ID_SIZE];
+            char* heapId;
+        };
+    };
+
+    static constexpr std::size_t MIN_CAPACITY = 16;
+    static constexpr std::size_t MAX_LOAD_NUM = 7;  // grow beyond 7/8 full
+    static constexpr std::size_t MAX_LOAD_DEN = 8;
+    static constexpr std::size_t NOT_FOUND = ~std::size_t(0);
+
+    std::vector<Slot> slots;
+    std::size_t mask = 0;
+    std::size_t count = 0;
+    std::size_t heapIdBytes = 0;
+
+    static std::uint64_t mix(std::uint64_t x) {
+        x ^= x >> 32;
+        x *= 0xD6E8FEB86659FD93ull;
+        x ^= x >> 32;
+        return x;
+    }
+
+    static std::uint16_t tagOf(std::uint64_t hash) { return static_cast<std::uint16_t>(hash >> 48); }
+
+    static std::string_view idOf(const Slot& slot) {
+        return {slot.length <= INLINE_ID_SIZE ? slot.inlineId : slot.heapId, slot.length};
+    }
+
+    void releaseId(Slot& slot) {
+        if (slot.length > INLINE_ID_SIZE) {
+            heapIdBytes -= slot.length;
+            delete[] slot.heapId;
+        }
+    }
+
+    void eraseSlot(std::size_t pos) {
+        releaseId(slots[pos]);
+
+        // Shift the following run back by one so no tombstone is left behind
+        std::size_t next = (pos + 1) & mask;
+        while (slots[next].dist > 1) {
+            slots[pos] = slots[next];
+            slots[pos].dist--;
+            pos = next;
+            next = (next + 1) & mask;
+        }
+        slots[pos] = Slot{};
+        count--;
+    }
+
+    std::size_t findSlot(std::string_view id, std::uint64_t hash) const {
+        if (slots.empty()) {
+            return NOT_FOUND;
+        }
+        std::uint16_t tag = tagOf(hash);
+        std::size_t pos = hash & mask;
+        for (std::uint16_t dist = 1; ; dist++) {
+            const Slot& slot = slots[pos];
+            // A shorter probe distance means the id would have displaced this slot
+            if (slot.dist < dist) {
+                return NOT_FOUND;
+            }
+            if (slot.tag == tag && slot.length == id.size() && idOf(slot) == id) {
+                return pos;
+            }
+            pos = (pos + 1) & mask;
+        }
+    }
+
+    // Robin Hood insert: take the slot of any entry closer to its home than we are
+    void place(Slot incoming, std::uint64_t hash) {
+        std::size_t pos = hash & mask;
+        incoming.dist = 1;
+        while (true) {
+            Slot& slot = slots[pos];
+            if (slot.dist == 0) {
+                slot = incoming;
+                return;
+            }
+            if (slot.dist < incoming.dist) {
+                std::swap(slot, incoming);
+            }
+            pos = (pos + 1) & mask;
+            incoming.dist++;
+        }
+    }
+
+    void rehash(std::size_t newCapacity) {
+        std::vector<Slot> previous = std::move(slots);
+        slots.assign(newCapacity, Slot{});
+        mask = newCapacity - 1;
+        for (auto& slot : previous) {
+            if (slot.dist != 0) {
+                place(slot, hashId(idOf(slot)));
+            }
+        }
+    }
+};
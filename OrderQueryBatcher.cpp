@@ -0,0 +1,123 @@
+#include "OrderQueryBatcher.h"
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <utility>
+
+OrderQueryBatcher::OrderQueryBatcher(OrderCache& cache, std::size_t maxBatchSize)
+    : cache(cache), maxBatchSize(std::max<std::size_t>(maxBatchSize, 1)), worker(&OrderQueryBatcher::run, this) {
+}
+
+OrderQueryBatcher::~OrderQueryBatcher() {
+    {
+        std::lock_guard lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_one();
+    worker.join();
+}
+
+// Queue a matching size query for a security
+std::future<unsigned int> OrderQueryBatcher::getMatchingSizeForSecurity(const std::string& securityId) {
+    MatchRequest request{securityId, {}};
+    std::future<unsigned int> result = request.result.get_future();
+    submit(std::move(request));
+    return result;
+}
+
+// Queue a minimum qty cancel for a security
+std::future<void> OrderQueryBatcher::cancelOrdersForSecIdWithMinimumQty(const std::string& securityId, unsigned int minQty) {
+    CancelRequest request{securityId, minQty, {}};
+    std::future<void> done = request.done.get_future();
+    submit(std::move(request));
+    return done;
+}
+
+void OrderQueryBatcher::submit(Request request) {
+    bool wasEmpty;
+    {
+        std::lock_guard lock(queueMutex);
+        wasEmpty = queue.empty();
+        queue.push_back(std::move(request));
+    }
+    // The worker only waits on an empty queue, so later submits need not wake it
+    if (wasEmpty) {
+        queueReady.notify_one();
+    }
+}
+
+// Worker loop: take up to maxBatchSize queued requests at a time and serve them
+void OrderQueryBatcher::run() {
+    std::vector<Request> batch;
+    while (true) {
+        {
+            std::unique_lock lock(queueMutex);
+            queueReady.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;  // stopping and nothing left to serve
+            }
+            std::size_t take = std::min(queue.size(), maxBatchSize);
+            batch.assign(std::make_move_iterator(queue.begin()), std::make_move_iterator(queue.begin() + take));
+            queue.erase(queue.begin(), queue.begin() + take);
+        }
+        serveBatch(batch);
+        batch.clear();
+    }
+}
+
+// Serve each run of same-kind requests with one bulk call, keeping submission order
+void OrderQueryBatcher::serveBatch(std::vector<Request>& batch) {
+    auto first = batch.begin();
+    while (first != batch.end()) {
+        std::size_t kind = first->index();
+        auto last = std::find_if(first, batch.end(), [kind](const Request& request) { return request.index() != kind; });
+        if (std::holds_alternative<MatchRequest>(*first)) {
+            serveMatches(first, last);
+        } else {
+            serveCancels(first, last);
+        }
+        first = last;
+    }
+}
+
+void OrderQueryBatcher::serveMatches(RequestIterator first, RequestIterator last) {
+    std::vector<std::string> securityIds;
+    securityIds.reserve(last - first);
+    for (auto it = first; it != last; ++it) {
+        securityIds.push_back(std::move(std::get<MatchRequest>(*it).securityId));
+    }
+
+    std::vector<unsigned int> sizes;
+    try {
+        cache.getMatchingSizesForSecurities(securityIds, sizes);
+    } catch (...) {
+        for (auto it = first; it != last; ++it) {
+            std::get<MatchRequest>(*it).result.set_exception(std::current_exception());
+        }
+        return;
+    }
+    for (auto it = first; it != last; ++it) {
+        std::get<MatchRequest>(*it).result.set_value(sizes[it - first]);
+    }
+}
+
+void OrderQueryBatcher::serveCancels(RequestIterator first, RequestIterator last) {
+    std::vector<std::pair<std::string, unsigned int>> requests;
+    requests.reserve(last - first);
+    for (auto it = first; it != last; ++it) {
+        auto& cancel = std::get<CancelRequest>(*it);
+        requests.emplace_back(std::move(cancel.securityId), cancel.minQty);
+    }
+
+    try {
+        cache.cancelOrdersForSecIdsWithMinimumQty(requests);
+    } catch (...) {
+        for (auto it = first; it != last; ++it) {
+            std::get<CancelRequest>(*it).done.set_exception(std::current_exception());
+        }
+        return;
+    }
+    for (auto it = first; it != last; ++it) {
+        std::get<CancelRequest>(*it).done.set_value();
+    }
+}
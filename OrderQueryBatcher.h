@@ -0,0 +1,67 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+#include "OrderCache.h"
+
+// Asynchronous front end for bursts of per-security queries from risk clients.
+//
+// Calls return a future straight away. A worker thread drains everything
+// submitted since its last pass and serves it through OrderCache's bulk
+// methods, so a burst from many clients costs one lock acquisition per run of
+// same-kind requests instead of one per call, and a security asked about
+// several times in a batch is matched or swept once. Requests are served in
+// submission order: a match submitted after a cancel sees its effect.
+class OrderQueryBatcher
+{
+public:
+    static constexpr std::size_t DEFAULT_MAX_BATCH_SIZE = 1024;
+
+    // maxBatchSize bounds how many requests are served under one lock, and so
+    // how long writers can be held off by a burst
+    explicit OrderQueryBatcher(OrderCache& cache, std::size_t maxBatchSize = DEFAULT_MAX_BATCH_SIZE);
+    OrderQueryBatcher(const OrderQueryBatcher&) = delete;
+    OrderQueryBatcher& operator=(const OrderQueryBatcher&) = delete;
+
+    // Serves every request already submitted, then stops the worker
+    ~OrderQueryBatcher();
+
+    // as OrderCache::getMatchingSizeForSecurity
+    std::future<unsigned int> getMatchingSizeForSecurity(const std::string& securityId);
+
+    // as OrderCache::cancelOrdersForSecIdWithMinimumQty
+    std::future<void> cancelOrdersForSecIdWithMinimumQty(const std::string& securityId, unsigned int minQty);
+
+private:
+    struct MatchRequest {
+        std::string securityId;
+        std::promise<unsigned int> result;
+    };
+    struct CancelRequest {
+        std::string securityId;
+        unsigned int minQty;
+        std::promise<void> done;
+    };
+    using Request = std::variant<MatchRequest, CancelRequest>;
+    using RequestIterator = std::vector<Request>::iterator;
+
+    OrderCache& cache;
+    std::size_t maxBatchSize;
+
+    std::mutex queueMutex;               // Guards queue and stopping
+    std::condition_variable queueReady;
+    std::deque<Request> queue;
+    bool stopping = false;
+    std::thread worker;                  // Started last, once the members above exist
+
+    void submit(Request request);
+    void run();
+    void serveBatch(std::vector<Request>& batch);
+    void serveMatches(RequestIterator first, RequestIterator last);
+    void serveCancels(RequestIterator first, RequestIterator last);
+};
@@ -0,0 +1,388 @@
+#include "OrderWorkload.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <random>
+
+namespace {
+
+constexpr char WORKLOAD_MAGIC[4] = {'O', 'C', 'W', 'L'};
+constexpr std::uint32_t WORKLOAD_VERSION = 1;
+constexpr std::size_t WORKLOAD_RECORD_SIZE = 22;  // type, side and five uint32 fields
+
+// Portable helpers on top of mt19937_64, whose output is fixed by the standard
+// (the std distributions are not, so they would break reproducibility)
+std::uint32_t nextIndex(std::mt19937_64& gen, std::uint32_t bound) {
+    return static_cast<std::uint32_t>(gen() % bound);
+}
+
+double nextUnit(std::mt19937_64& gen) {
+    return (gen() >> 11) * (1.0 / 9007199254740992.0);  // 53 random bits in [0, 1)
+}
+
+// Samples ranks 0..n-1 with probability proportional to 1 / (rank + 1)^skew
+class ZipfSampler {
+public:
+    ZipfSampler(std::uint32_t n, double skew) : cdf(n) {
+        double total = 0;
+        for (std::uint32_t i = 0; i < n; i++) {
+            total += 1.0 / std::pow(i + 1.0, skew);
+            cdf[i] = total;
+        }
+        for (auto& c : cdf) {
+            c /= total;
+        }
+    }
+
+    std::uint32_t operator()(std::mt19937_64& gen) const {
+        auto it = std::upper_bound(cdf.begin(), cdf.end(), nextUnit(gen));
+        return static_cast<std::uint32_t>(std::min<std::size_t>(it - cdf.begin(), cdf.size() - 1));
+    }
+
+private:
+    std::vector<double> cdf;
+};
+
+// Generator-side model of the cache, so cancels target orders that are still live
+struct LiveOrder {
+    std::uint32_t secId;
+    std::uint32_t user;
+    std::uint32_t qty;
+    bool live;
+};
+
+void putU32(unsigned char* p, std::uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = static_cast<unsigned char>(v >> (8 * i));
+    }
+}
+
+std::uint32_t getU32(const unsigned char* p) {
+    std::uint32_t v = 0;
+    for (int i = 0; i < 4; i++) {
+        v |= static_cast<std::uint32_t>(p[i]) << (8 * i);
+    }
+    return v;
+}
+
+std::uint64_t percentile(const std::vector<std::uint64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    auto idx = static_cast<std::size_t>(p * (sorted.size() - 1));
+    return sorted[idx];
+}
+
+}  // namespace
+
+const char* workloadOpName(WorkloadOpType type) {
+    switch (type) {
+        case WorkloadOpType::Add:                  return "addOrder";
+        case WorkloadOpType::Cancel:               return "cancelOrder";
+        case WorkloadOpType::CancelForUser:        return "cancelOrdersForUser";
+        case WorkloadOpType::CancelForSecIdMinQty: return "cancelOrdersForSecIdWithMinimumQty";
+        case WorkloadOpType::MatchQuery:           return "getMatchingSizeForSecurity";
+    }
+    return "unknown";
+}
+
+// Generate a seeded op stream
+std::vector<WorkloadOp> generateWorkload(const WorkloadConfig& config) {
+    std::mt19937_64 gen(config.seed);
+    ZipfSampler securities(config.numSecurities, config.securitySkew);
+    ZipfSampler users(config.numUsers, config.userSkew);
+
+    std::vector<WorkloadOp> ops;
+    ops.reserve(config.numOps);
+
+    std::vector<LiveOrder> orders;                           // indexed by orderId
+    std::vector<std::uint32_t> liveIds;                      // may hold stale ids, dropped lazily
+    std::vector<std::vector<std::uint32_t>> idsByUser(config.numUsers);
+    std::vector<std::vector<std::uint32_t>> idsBySecId(config.numSecurities);
+
+    const unsigned int weights[] = {config.addWeight, config.cancelWeight, config.replaceWeight,
+                                    config.cancelForUserWeight, config.minQtySweepWeight, config.matchWeight};
+    unsigned int totalWeight = 0;
+    for (auto w : weights) {
+        totalWeight += w;
+    }
+    if (totalWeight == 0) {
+        return ops;
+    }
+
+    std::uint32_t lastSecId = securities(gen);
+    auto pickSecId = [&]() {
+        if (nextUnit(gen) >= config.burstiness) {
+            lastSecId = securities(gen);
+        }
+        return lastSecId;
+    };
+
+    auto emitAdd = [&](std::uint32_t secId, std::uint32_t user) {
+        WorkloadOp op;
+        op.type = WorkloadOpType::Add;
+        op.side = static_cast<std::uint8_t>(nextIndex(gen, 2));
+        op.orderId = static_cast<std::uint32_t>(orders.size());
+        op.secId = secId;
+        op.user = user;
+        op.company = user % config.numCompanies;  // users stay in one company
+        op.qty = (nextIndex(gen, 50) + 1) * 100;
+        orders.push_back(LiveOrder{secId, user, op.qty, true});
+        liveIds.push_back(op.orderId);
+        idsByUser[user].push_back(op.orderId);
+        idsBySecId[secId].push_back(op.orderId);
+        ops.push_back(op);
+    };
+
+    // Cancel a random live order, returning false when the book is empty
+    auto emitCancel = [&](LiveOrder* cancelled) {
+        while (!liveIds.empty()) {
+            std::uint32_t slot = nextIndex(gen, static_cast<std::uint32_t>(liveIds.size()));
+            std::uint32_t id = liveIds[slot];
+            liveIds[slot] = liveIds.back();
+            liveIds.pop_back();
+            if (orders[id].live) {
+                orders[id].live = false;
+                WorkloadOp op;
+                op.type = WorkloadOpType::Cancel;
+                op.orderId = id;
+                ops.push_back(op);
+                if (cancelled) {
+                    *cancelled = orders[id];
+                }
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // Add on a freshly drawn security and user. Both draw from gen, so they are
+    // taken in a fixed order rather than as arguments, whose order is unspecified.
+    auto emitNewAdd = [&]() {
+        std::uint32_t secId = pickSecId();
+        std::uint32_t user = users(gen);
+        emitAdd(secId, user);
+    };
+
+    while (ops.size() < config.numOps) {
+        unsigned int pick = nextIndex(gen, totalWeight);
+        std::size_t kind = 0;
+        while (pick >= weights[kind]) {
+            pick -= weights[kind];
+            kind++;
+        }
+
+        switch (kind) {
+            case 0:  // add
+                emitNewAdd();
+                break;
+            case 1:  // cancel
+                if (!emitCancel(nullptr)) {
+                    emitNewAdd();
+                }
+                break;
+            case 2: {  // replace, as cancel + add on the same security for the same user
+                LiveOrder cancelled{};
+                if (!emitCancel(&cancelled)) {
+                    emitNewAdd();
+                } else if (ops.size() < config.numOps) {
+                    emitAdd(cancelled.secId, cancelled.user);
+                }
+                break;
+            }
+            case 3: {  // cancel for user
+                WorkloadOp op;
+                op.type = WorkloadOpType::CancelForUser;
+                op.user = users(gen);
+                for (auto id : idsByUser[op.user]) {
+                    orders[id].live = false;
+                }
+                idsByUser[op.user].clear();
+                ops.push_back(op);
+                break;
+            }
+            case 4: {  // minimum qty sweep
+                WorkloadOp op;
+                op.type = WorkloadOpType::CancelForSecIdMinQty;
+                op.secId = pickSecId();
+                op.qty = (nextIndex(gen, 50) + 1) * 100;
+                auto& ids = idsBySecId[op.secId];
+                ids.erase(std::remove_if(ids.begin(), ids.end(), [&](std::uint32_t id) {
+                    if (orders[id].live && orders[id].qty >= op.qty) {
+                        orders[id].live = false;
+                    }
+                    return !orders[id].live;
+                }), ids.end());
+                ops.push_back(op);
+                break;
+            }
+            default: {  // match query
+                WorkloadOp op;
+                op.type = WorkloadOpType::MatchQuery;
+                op.secId = pickSecId();
+                ops.push_back(op);
+                break;
+            }
+        }
+    }
+
+    return ops;
+}
+
+// Write ops as a header followed by fixed-size records
+bool writeWorkload(const std::string& path, const std::vector<WorkloadOp>& ops) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+
+    unsigned char header[16] = {};
+    std::copy(std::begin(WORKLOAD_MAGIC), std::end(WORKLOAD_MAGIC), header);
+    putU32(header + 4, WORKLOAD_VERSION);
+    putU32(header + 8, static_cast<std::uint32_t>(ops.size()));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    unsigned char record[WORKLOAD_RECORD_SIZE];
+    for (const auto& op : ops) {
+        record[0] = static_cast<unsigned char>(op.type);
+        record[1] = op.side;
+        putU32(record + 2, op.orderId);
+        putU32(record + 6, op.secId);
+        putU32(record + 10, op.user);
+        putU32(record + 14, op.company);
+        putU32(record + 18, op.qty);
+        out.write(reinterpret_cast<const char*>(record), sizeof(record));
+    }
+    return static_cast<bool>(out);
+}
+
+// Read ops written by writeWorkload
+bool readWorkload(const std::string& path, std::vector<WorkloadOp>& ops) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    unsigned char header[16];
+    if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        !std::equal(std::begin(WORKLOAD_MAGIC), std::end(WORKLOAD_MAGIC), header) ||
+        getU32(header + 4) != WORKLOAD_VERSION) {
+        return false;
+    }
+
+    std::uint32_t count = getU32(header + 8);
+    ops.clear();
+    ops.reserve(count);
+    unsigned char record[WORKLOAD_RECORD_SIZE];
+    for (std::uint32_t i = 0; i < count; i++) {
+        if (!in.read(reinterpret_cast<char*>(record), sizeof(record)) || record[0] >= NUM_WORKLOAD_OP_TYPES) {
+            return false;
+        }
+        WorkloadOp op;
+        op.type = static_cast<WorkloadOpType>(record[0]);
+        op.side = record[1];
+        op.orderId = getU32(record + 2);
+        op.secId = getU32(record + 6);
+        op.user = getU32(record + 10);
+        op.company = getU32(record + 14);
+        op.qty = getU32(record + 18);
+        ops.push_back(op);
+    }
+    return true;
+}
+
+// Replay ops against the cache. All strings and Orders are built up front so
+// only the cache calls themselves are timed.
+WorkloadReplayReport replayWorkload(OrderCacheInterface& cache, const std::vector<WorkloadOp>& ops) {
+    std::uint32_t maxOrderId = 0, maxSecId = 0, maxUser = 0, maxCompany = 0;
+    for (const auto& op : ops) {
+        maxOrderId = std::max(maxOrderId, op.orderId);
+        maxSecId = std::max(maxSecId, op.secId);
+        maxUser = std::max(maxUser, op.user);
+        maxCompany = std::max(maxCompany, op.company);
+    }
+
+    std::vector<std::string> orderIds, secIds, users, companies;
+    for (std::uint32_t i = 0; i <= maxOrderId; i++) orderIds.push_back("OrdId" + std::to_string(i));
+    for (std::uint32_t i = 0; i <= maxSecId; i++) secIds.push_back("SecId" + std::to_string(i));
+    for (std::uint32_t i = 0; i <= maxUser; i++) users.push_back("User" + std::to_string(i));
+    for (std::uint32_t i = 0; i <= maxCompany; i++) companies.push_back("Comp" + std::to_string(i));
+    const std::string sides[] = {"Buy", "Sell"};
+
+    std::vector<Order> addOrders;
+    for (const auto& op : ops) {
+        if (op.type == WorkloadOpType::Add) {
+            addOrders.push_back(Order{orderIds[op.orderId], secIds[op.secId], sides[op.side & 1],
+                                      op.qty, users[op.user], companies[op.company]});
+        }
+    }
+
+    std::vector<std::uint64_t> latencies[NUM_WORKLOAD_OP_TYPES];
+    std::size_t nextAdd = 0;
+    auto replayStart = std::chrono::steady_clock::now();
+    for (const auto& op : ops) {
+        auto start = std::chrono::steady_clock::now();
+        switch (op.type) {
+            case WorkloadOpType::Add:
+                cache.addOrder(std::move(addOrders[nextAdd++]));
+                break;
+            case WorkloadOpType::Cancel:
+                cache.cancelOrder(orderIds[op.orderId]);
+                break;
+            case WorkloadOpType::CancelForUser:
+                cache.cancelOrdersForUser(users[op.user]);
+                break;
+            case WorkloadOpType::CancelForSecIdMinQty:
+                cache.cancelOrdersForSecIdWithMinimumQty(secIds[op.secId], op.qty);
+                break;
+            case WorkloadOpType::MatchQuery:
+                cache.getMatchingSizeForSecurity(secIds[op.secId]);
+                break;
+        }
+        auto end = std::chrono::steady_clock::now();
+        latencies[static_cast<std::size_t>(op.type)].push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    auto replayEnd = std::chrono::steady_clock::now();
+
+    WorkloadReplayReport report;
+    report.totalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(replayEnd - replayStart).count();
+    for (std::size_t i = 0; i < NUM_WORKLOAD_OP_TYPES; i++) {
+        auto& samples = latencies[i];
+        std::sort(samples.begin(), samples.end());
+        auto& stats = report.perOp[i];
+        stats.count = samples.size();
+        for (auto ns : samples) {
+            stats.totalNs += ns;
+        }
+        stats.p50Ns = percentile(samples, 0.50);
+        stats.p99Ns = percentile(samples, 0.99);
+        stats.p999Ns = percentile(samples, 0.999);
+        stats.maxNs = samples.empty() ? 0 : samples.back();
+    }
+    return report;
+}
+
+// Print the replay report as a table
+void printReplayReport(std::ostream& os, const WorkloadReplayReport& report) {
+    std::uint64_t totalOps = 0;
+    os << std::left << std::setw(36) << "op" << std::right
+       << std::setw(10) << "count" << std::setw(12) << "mean(ns)" << std::setw(12) << "p50(ns)"
+       << std::setw(12) << "p99(ns)" << std::setw(12) << "p99.9(ns)" << std::setw(14) << "max(ns)" << "\n";
+    for (std::size_t i = 0; i < NUM_WORKLOAD_OP_TYPES; i++) {
+        const auto& stats = report.perOp[i];
+        totalOps += stats.count;
+        if (stats.count == 0) {
+            continue;
+        }
+        os << std::left << std::setw(36) << workloadOpName(static_cast<WorkloadOpType>(i)) << std::right
+           << std::setw(10) << stats.count << std::setw(12) << stats.totalNs / stats.count
+           << std::setw(12) << stats.p50Ns << std::setw(12) << stats.p99Ns
+           << std::setw(12) << stats.p999Ns << std::setw(14) << stats.maxNs << "\n";
+    }
+    double seconds = report.totalNs / 1e9;
+    os << "total " << totalOps << " ops in " << seconds << " s ("
+       << (seconds > 0 ? totalOps / seconds : 0) << " ops/s)\n";
+}
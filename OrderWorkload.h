@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "OrderCache.h"
+
+// Kinds of operation recorded in a workload stream
+enum class WorkloadOpType : std::uint8_t {
+    Add = 0,
+    Cancel = 1,
+    CancelForUser = 2,
+    CancelForSecIdMinQty = 3,
+    MatchQuery = 4,
+};
+
+constexpr std::size_t NUM_WORKLOAD_OP_TYPES = 5;
+
+// Name of an op type, as printed in replay reports
+const char* workloadOpName(WorkloadOpType type);
+
+// One recorded operation. Ids are plain indexes; the replayer expands them into
+// the "OrdId<n>", "SecId<n>", "User<n>" and "Comp<n>" strings used by the tests.
+struct WorkloadOp {
+    WorkloadOpType type = WorkloadOpType::Add;
+    std::uint8_t side = 0;        // 0 = Buy, 1 = Sell (Add only)
+    std::uint32_t orderId = 0;    // Add, Cancel
+    std::uint32_t secId = 0;      // Add, CancelForSecIdMinQty, MatchQuery
+    std::uint32_t user = 0;       // Add, CancelForUser
+    std::uint32_t company = 0;    // Add
+    std::uint32_t qty = 0;        // qty for Add, minimum qty for CancelForSecIdMinQty
+};
+
+// Shape of a generated stream. The same config always yields the same stream.
+struct WorkloadConfig {
+    std::uint64_t seed = 1;
+    std::uint32_t numOps = 1000000;
+    std::uint32_t numSecurities = 1000;
+    std::uint32_t numUsers = 1000;
+    std::uint32_t numCompanies = 100;
+
+    double securitySkew = 1.0;  // Zipf exponent for security choice, 0 = uniform
+    double userSkew = 0.5;      // Zipf exponent for user choice, 0 = uniform
+    double burstiness = 0.3;    // probability an op stays on the previous op's security
+
+    // Relative weights of each kind of message. A replace is recorded as a
+    // cancel followed by an add on the same security for the same user.
+    unsigned int addWeight = 35;
+    unsigned int cancelWeight = 25;
+    unsigned int replaceWeight = 25;
+    unsigned int cancelForUserWeight = 1;
+    unsigned int minQtySweepWeight = 2;
+    unsigned int matchWeight = 12;
+};
+
+// Generate a seeded, reproducible op stream of exactly config.numOps ops
+std::vector<WorkloadOp> generateWorkload(const WorkloadConfig& config);
+
+// Binary stream I/O, little-endian and platform independent. Return false on failure.
+bool writeWorkload(const std::string& path, const std::vector<WorkloadOp>& ops);
+bool readWorkload(const std::string& path, std::vector<WorkloadOp>& ops);
+
+// Latency summary for one op type
+struct WorkloadOpStats {
+    std::uint64_t count = 0;
+    std::uint64_t totalNs = 0;
+    std::uint64_t p50Ns = 0;
+    std::uint64_t p99Ns = 0;
+    std::uint64_t p999Ns = 0;
+    std::uint64_t maxNs = 0;
+};
+
+struct WorkloadReplayReport {
+    std::uint64_t totalNs = 0;
+    WorkloadOpStats perOp[NUM_WORKLOAD_OP_TYPES];
+};
+
+// Drive any cache implementation with the op stream, timing every op
+WorkloadReplayReport replayWorkload(OrderCacheInterface& cache, const std::vector<WorkloadOp>& ops);
+
+// Print per-op latency and overall throughput
+void printReplayReport(std::ostream& os, const WorkloadReplayReport& report);
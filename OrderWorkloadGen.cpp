@@ -0,0 +1,64 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "OrderWorkload.h"
+
+// Generates a seeded order flow and writes it to a binary workload file.
+//
+//   OrderWorkloadGen -o flow.bin [--seed N] [--ops N] [--securities N] [--users N]
+//                    [--companies N] [--security-skew S] [--user-skew S] [--burstiness P]
+//                    [--add W] [--cancel W] [--replace W] [--cancel-user W]
+//                    [--min-qty-sweep W] [--match W]
+
+static void usage(const char* argv0) {
+    std::cerr << "usage: " << argv0 << " -o <file> [--seed N] [--ops N] [--securities N] [--users N]\n"
+              << "       [--companies N] [--security-skew S] [--user-skew S] [--burstiness P]\n"
+              << "       [--add W] [--cancel W] [--replace W] [--cancel-user W] [--min-qty-sweep W] [--match W]\n";
+}
+
+int main(int argc, char** argv) {
+    WorkloadConfig config;
+    std::string outPath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (arg == "-o")                    outPath = value;
+        else if (arg == "--seed")           config.seed = std::strtoull(value, nullptr, 10);
+        else if (arg == "--ops")            config.numOps = std::strtoul(value, nullptr, 10);
+        else if (arg == "--securities")     config.numSecurities = std::strtoul(value, nullptr, 10);
+        else if (arg == "--users")          config.numUsers = std::strtoul(value, nullptr, 10);
+        else if (arg == "--companies")      config.numCompanies = std::strtoul(value, nullptr, 10);
+        else if (arg == "--security-skew")  config.securitySkew = std::strtod(value, nullptr);
+        else if (arg == "--user-skew")      config.userSkew = std::strtod(value, nullptr);
+        else if (arg == "--burstiness")     config.burstiness = std::strtod(value, nullptr);
+        else if (arg == "--add")            config.addWeight = std::strtoul(value, nullptr, 10);
+        else if (arg == "--cancel")         config.cancelWeight = std::strtoul(value, nullptr, 10);
+        else if (arg == "--replace")        config.replaceWeight = std::strtoul(value, nullptr, 10);
+        else if (arg == "--cancel-user")    config.cancelForUserWeight = std::strtoul(value, nullptr, 10);
+        else if (arg == "--min-qty-sweep")  config.minQtySweepWeight = std::strtoul(value, nullptr, 10);
+        else if (arg == "--match")          config.matchWeight = std::strtoul(value, nullptr, 10);
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (outPath.empty() || config.numSecurities == 0 || config.numUsers == 0 || config.numCompanies == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<WorkloadOp> ops = generateWorkload(config);
+    if (!writeWorkload(outPath, ops)) {
+        std::cerr << "failed to write " << outPath << "\n";
+        return 1;
+    }
+    std::cout << "wrote " << ops.size() << " ops to " << outPath << "\n";
+    return 0;
+}
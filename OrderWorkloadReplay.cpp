@@ -0,0 +1,43 @@
+#include <iostream>
+#include <string>
+#include "OrderCache.h"
+#include "OrderWorkload.h"
+
+// Replays a workload file written by OrderWorkloadGen against OrderCache and
+// reports per-op latency, overall throughput and the memory held by the cache
+// once the stream has been applied.
+//
+//   OrderWorkloadReplay flow.bin
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "usage: " << argv[0] << " <workload file>\n";
+        return 1;
+    }
+
+    std::vector<WorkloadOp> ops;
+    if (!readWorkload(argv[1], ops)) {
+        std::cerr << "failed to read workload " << argv[1] << "\n";
+        return 1;
+    }
+
+    OrderCache cache;
+    WorkloadReplayReport report = replayWorkload(cache, ops);
+    printReplayReport(std::cout, report);
+
+    OrderCacheMemoryUsage usage = cache.memoryUsage();
+    std::size_t openOrders = cache.getAllOrders().size();
+    std::cout << "memory for " << openOrders << " open orders (bytes)\n"
+              << "  ordersBySecId    " << usage.ordersBySecId << "\n"
+              << "  ordersById       " << usage.ordersById << "\n"
+              << "  ordersByUser     " << usage.ordersByUser << "\n"
+              << "  securityIndexes  " << usage.securityIndexes << "\n"
+              << "  ordersBySession  " << usage.ordersBySession << "\n"
+              << "  strings          " << usage.strings << "\n"
+              << "  total            " << usage.total();
+    if (openOrders > 0) {
+        std::cout << " (" << usage.total() / openOrders << " per order)";
+    }
+    std::cout << "\n";
+    return 0;
+}